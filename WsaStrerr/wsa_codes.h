@@ -0,0 +1,108 @@
+﻿// wsa_codes.h: WSA error code constants.
+// On Windows they come from <WinSock2.h>. Elsewhere the same names and values are defined
+// here, so that the lookup table can be compiled and exercised without the Windows SDK.
+#pragma once
+
+#if defined(_WIN32)
+#include <WinSock2.h>
+#else
+/* Windows error codes reused by Windows Sockets (winerror.h) */
+#define WSA_INVALID_HANDLE          6L
+#define WSA_NOT_ENOUGH_MEMORY       8L
+#define WSA_INVALID_PARAMETER       87L
+#define WSA_OPERATION_ABORTED       995L
+#define WSA_IO_INCOMPLETE           996L
+#define WSA_IO_PENDING              997L
+
+/* Windows Sockets error codes (winerror.h) */
+#define WSABASEERR                  10000L
+#define WSAEINTR                    10004L
+#define WSAEBADF                    10009L
+#define WSAEACCES                   10013L
+#define WSAEFAULT                   10014L
+#define WSAEINVAL                   10022L
+#define WSAEMFILE                   10024L
+#define WSAEWOULDBLOCK              10035L
+#define WSAEINPROGRESS              10036L
+#define WSAEALREADY                 10037L
+#define WSAENOTSOCK                 10038L
+#define WSAEDESTADDRREQ             10039L
+#define WSAEMSGSIZE                 10040L
+#define WSAEPROTOTYPE               10041L
+#define WSAENOPROTOOPT              10042L
+#define WSAEPROTONOSUPPORT          10043L
+#define WSAESOCKTNOSUPPORT          10044L
+#define WSAEOPNOTSUPP               10045L
+#define WSAEPFNOSUPPORT             10046L
+#define WSAEAFNOSUPPORT             10047L
+#define WSAEADDRINUSE               10048L
+#define WSAEADDRNOTAVAIL            10049L
+#define WSAENETDOWN                 10050L
+#define WSAENETUNREACH              10051L
+#define WSAENETRESET                10052L
+#define WSAECONNABORTED             10053L
+#define WSAECONNRESET               10054L
+#define WSAENOBUFS                  10055L
+#define WSAEISCONN                  10056L
+#define WSAENOTCONN                 10057L
+#define WSAESHUTDOWN                10058L
+#define WSAETOOMANYREFS             10059L
+#define WSAETIMEDOUT                10060L
+#define WSAECONNREFUSED             10061L
+#define WSAELOOP                    10062L
+#define WSAENAMETOOLONG             10063L
+#define WSAEHOSTDOWN                10064L
+#define WSAEHOSTUNREACH             10065L
+#define WSAENOTEMPTY                10066L
+#define WSAEPROCLIM                 10067L
+#define WSAEUSERS                   10068L
+#define WSAEDQUOT                   10069L
+#define WSAESTALE                   10070L
+#define WSAEREMOTE                  10071L
+#define WSASYSNOTREADY              10091L
+#define WSAVERNOTSUPPORTED          10092L
+#define WSANOTINITIALISED           10093L
+#define WSAEDISCON                  10101L
+#define WSAENOMORE                  10102L
+#define WSAECANCELLED               10103L
+#define WSAEINVALIDPROCTABLE        10104L
+#define WSAEINVALIDPROVIDER         10105L
+#define WSAEPROVIDERFAILEDINIT      10106L
+#define WSASYSCALLFAILURE           10107L
+#define WSASERVICE_NOT_FOUND        10108L
+#define WSATYPE_NOT_FOUND           10109L
+#define WSA_E_NO_MORE               10110L
+#define WSA_E_CANCELLED             10111L
+#define WSAEREFUSED                 10112L
+#define WSAHOST_NOT_FOUND           11001L
+#define WSATRY_AGAIN                11002L
+#define WSANO_RECOVERY              11003L
+#define WSANO_DATA                  11004L
+#define WSA_QOS_RECEIVERS           11005L
+#define WSA_QOS_SENDERS             11006L
+#define WSA_QOS_NO_SENDERS          11007L
+#define WSA_QOS_NO_RECEIVERS        11008L
+#define WSA_QOS_REQUEST_CONFIRMED   11009L
+#define WSA_QOS_ADMISSION_FAILURE   11010L
+#define WSA_QOS_POLICY_FAILURE      11011L
+#define WSA_QOS_BAD_STYLE           11012L
+#define WSA_QOS_BAD_OBJECT          11013L
+#define WSA_QOS_TRAFFIC_CTRL_ERROR  11014L
+#define WSA_QOS_GENERIC_ERROR       11015L
+#define WSA_QOS_ESERVICETYPE        11016L
+#define WSA_QOS_EFLOWSPEC           11017L
+#define WSA_QOS_EPROVSPECBUF        11018L
+#define WSA_QOS_EFILTERSTYLE        11019L
+#define WSA_QOS_EFILTERTYPE         11020L
+#define WSA_QOS_EFILTERCOUNT        11021L
+#define WSA_QOS_EOBJLENGTH          11022L
+#define WSA_QOS_EFLOWCOUNT          11023L
+#define WSA_QOS_EUNKOWNPSOBJ        11024L
+#define WSA_QOS_EPOLICYOBJ          11025L
+#define WSA_QOS_EFLOWDESC           11026L
+#define WSA_QOS_EPSFLOWSPEC         11027L
+#define WSA_QOS_EPSFILTERSPEC       11028L
+#define WSA_QOS_ESDMODEOBJ          11029L
+#define WSA_QOS_ESHAPERATEOBJ       11030L
+#define WSA_QOS_RESERVED_PETYPE     11031L
+#endif // _WIN32
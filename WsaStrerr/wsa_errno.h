@@ -0,0 +1,54 @@
+﻿// wsa_errno.h: WSA错误码与POSIX errno互相转换, 以及两个平台上文字相同的socket错误描述
+// 全部是constexpr函数, 只需要包含本头文件, 不需要链接DLL; 转换表在编译期生成, 每次转换只是一次查表,
+// 不调用依赖locale的strerror. 在Windows和Linux上共用的网络代码可以用同一套错误处理:
+//     int iErr = WSAGetLastError();                       /* Linux下为 int iErr = errno; */
+//     log(wsa_strerr::socket_strerror(iErr));            /* 两个平台输出相同的文字 */
+//     if (wsa_strerr::socket_error_to_wsa(iErr) == WSAEWOULDBLOCK) { ... }
+// 注意: socket_error_to_wsa按Windows上同一情况报告的错误码转换, 与errno_to_wsa有两处不同:
+// 非阻塞connect()在Linux下报告EINPROGRESS, 在Windows下报告WSAEWOULDBLOCK, 所以EINPROGRESS转换为WSAEWOULDBLOCK;
+// 被取消的I/O在Linux下报告ECANCELED, 在Windows下报告WSA_OPERATION_ABORTED, 所以ECANCELED转换为WSA_OPERATION_ABORTED
+#pragma once
+
+#include "wsa_error_errc.h"
+#include "wsa_error_table.h"
+
+namespace wsa_strerr
+{
+	/* WSA错误码对应的errno(当前平台<cerrno>中的值), 例如WSAECONNRESET返回ECONNRESET; 没有对应的errno时返回0 */
+	constexpr int wsa_to_errno(unsigned long ulErrno) noexcept
+	{
+		return LookupErrno(ulErrno);
+	}
+
+	/* errno对应的WSA错误码, 例如ECONNRESET返回WSAECONNRESET; 多个WSA错误码对应同一个errno时返回socket函数使用的那个
+	 * (EINVAL返回WSAEINVAL, ECANCELED返回WSAECANCELLED); 没有对应的WSA错误码时返回0 */
+	constexpr unsigned long errno_to_wsa(int iErrno) noexcept
+	{
+		return LookupWsaFromErrno(iErrno);
+	}
+
+	/* 当前平台socket函数报告的错误码(Windows下是WSAGetLastError()的返回值, 其他平台是errno)转换为WSA错误码,
+	 * 结果是Windows在同一情况下报告的错误码: EINPROGRESS返回WSAEWOULDBLOCK(非阻塞connect()),
+	 * ECANCELED返回WSA_OPERATION_ABORTED(被取消的I/O); 其余errno与errno_to_wsa相同 */
+	constexpr unsigned long socket_error_to_wsa(int iError) noexcept
+	{
+#if defined(_WIN32)
+		return static_cast<unsigned long>(iError);
+#else
+		switch (iError)
+		{
+		case EINPROGRESS: return WSAEWOULDBLOCK;
+		case ECANCELED: return WSA_OPERATION_ABORTED;
+		default: return LookupWsaFromErrno(iError);
+		}
+#endif
+	}
+
+	/* 当前平台socket函数报告的错误码的描述信息, 同一个错误在两个平台上返回相同的文字(与WSAStrError(socket_error_to_wsa(iError))相同),
+	 * 例如Windows下的WSAECONNRESET和Linux下的ECONNRESET都返回"Connection reset by peer".
+	 * 没有对应WSA错误码的errno返回"Unknown error". 返回的字符串是静态只读的 */
+	constexpr const char* socket_strerror(int iError) noexcept
+	{
+		return LookupMessage(socket_error_to_wsa(iError));
+	}
+}
@@ -4,19 +4,91 @@
 // 任何项目上不应定义此符号。这样，源文件中包含此文件的任何其他项目都会将
 // WSAERROR_API 函数视为是从 DLL 导入的，而此 DLL 则将用此宏定义的
 // 符号视为是被导出的。
+#pragma once
+
+#include <stddef.h>
+
+#if defined(_WIN32)
 #ifdef WSAERROR_EXPORTS
 #define WSAERROR_API __declspec(dllexport)
 #else
 #define WSAERROR_API __declspec(dllimport)
 #endif
+#else
+#define WSAERROR_API __attribute__((visibility("default")))
+#endif
+
+#define WSA_STRERR_API extern "C" WSAERROR_API
+
+/* 返回错误码的描述信息, 未知错误码返回"Unknown error". 返回的字符串是静态只读的, 无需释放 */
+WSA_STRERR_API const char* WSAStrError(unsigned long ulErrno);
+
+/* 返回错误码的完整说明(MSDN中的解释), 未知错误码返回"Unknown error". 说明文字单独存放, 不影响WSAStrError的查表性能 */
+WSA_STRERR_API const char* WSAStrErrorDetail(unsigned long ulErrno);
+
+/* 返回错误码的符号名, 例如10054返回"WSAECONNRESET"; 未知错误码返回NULL */
+WSA_STRERR_API const char* WSAErrorName(unsigned long ulErrno);
+
+/* 由符号名得到错误码, 例如"WSAECONNRESET"返回10054, 区分大小写; 未知的名字返回0.
+ * 使用编译期生成的完美哈希, 只需一次字符串比较 */
+WSA_STRERR_API unsigned long WSAErrorFromName(const char* pszName);
+
+/* WSAStrError_r 的格式选项 */
+#define WSA_STRERR_WITH_CODE 0x1u /* 追加错误码, 例如"Connection reset by peer (10054)" */
+#define WSA_STRERR_WITH_NAME 0x2u /* 追加错误码的符号名, 例如"Connection reset by peer (WSAECONNRESET)" */
+
+/* 可重入版本, 类似strerror_r: 把描述信息写入调用者提供的缓冲区, 总是以'\0'结尾(ulBufLen为0时不写入任何内容), 空间不足时截断.
+ * 不分配内存, 不依赖locale, 可在网络线程中放心使用.
+ * 返回写入的字符数(不含'\0') */
+WSA_STRERR_API size_t WSAStrError_r(unsigned long ulErrno, char* pBuf, size_t ulBufLen, unsigned int uFlags);
+
+/* 批量版本: 把pCodes中的n个错误码逐一翻译, 结果写入ppOut[0..n-1], 与逐个调用WSAStrError的结果完全相同.
+ * 支持时使用SSE2/AVX2一次判断多个错误码所在的区间 */
+WSA_STRERR_API void WSAStrErrorBatch(const unsigned long* pCodes, size_t n, const char** ppOut);
+
+/* 错误统计: 按错误码计数, 计数器按线程分片, 多线程同时计数时互不争用缓存行 */
+typedef struct WSAErrorCount
+{
+	unsigned long ulErrno;         /* 错误码, 不在错误码表范围内的错误码汇总为WSA_ERROR_STATS_OTHER */
+	unsigned long long ullCount;   /* 次数 */
+} WSAErrorCount;
+
+#define WSA_ERROR_STATS_OTHER 0xFFFFFFFFul
+
+/* 记录一次错误 */
+WSA_STRERR_API void WSARecordError(unsigned long ulErrno);
+
+/* bEnable非0时WSAStrError、WSAStrError_r和WSAStrErrorBatch每翻译一个错误码也记录一次错误, 默认关闭 */
+WSA_STRERR_API void WSAErrorStatsCountLookups(int bEnable);
+
+/* 汇总各分片的计数, 把次数非0的错误码写入pCounts(最多ulMaxCounts项, 按错误码区间的顺序).
+ * bReset非0时清零已写入的错误码的计数, 清零与并发的计数互不影响, 不会丢失计数.
+ * 返回次数非0的错误码总数, 大于ulMaxCounts时说明缓冲区不够; pCounts可以为NULL, 只统计数量 */
+WSA_STRERR_API size_t WSAErrorStatsSnapshot(WSAErrorCount* pCounts, size_t ulMaxCounts, int bReset);
+
+/* 异步错误日志: 网络线程只把定长记录(错误码, 时间戳, 上下文ID, 调用者标签)放进无锁的多生产者环形队列后立即返回,
+ * 由后台线程翻译错误码, 对重复的错误码限流, 再成批写入文件或交给回调函数 */
+typedef void (*WSAErrorLogCallback)(const char* pBatch, size_t ulLen, void* pContext);
+
+typedef struct WSAErrorLogConfig
+{
+	const char* pszFilePath;           /* 追加写入的日志文件, 与pfnCallback二选一 */
+	WSAErrorLogCallback pfnCallback;   /* 接收成批日志行的回调, 在后台线程中调用 */
+	void* pContext;                    /* 传给pfnCallback */
+	unsigned int uCapacity;            /* 环形队列能容纳的记录数, 向上取整为2的幂, 0表示4096, 最大1048576 */
+	unsigned int uFlushIntervalMs;     /* 输出和限流的周期(毫秒), 0表示1000 */
+	unsigned int uMaxPerCode;          /* 每个周期内同一错误码最多输出的行数, 超出的只汇总计数; 0表示不限流 */
+} WSAErrorLogConfig;
+
+/* 启动后台线程, 成功返回0; 已经启动、参数错误、文件打不开或内存/线程创建失败时返回-1.
+ * 第一次调用后DLL被固定, FreeLibrary不再卸载它, 直到进程结束 */
+WSA_STRERR_API int WSAErrorLogStart(const WSAErrorLogConfig* pConfig);
 
-// 此类是从 dll 导出的
-class WSAERROR_API Cwsaerror {
-public:
-	Cwsaerror(void);
-	// TODO: 在此处添加方法。
-};
+/* 输出队列中剩余的记录后停止后台线程. 不要在DllMain中调用; 进程退出前没有调用时, 尚未输出的记录会丢失 */
+WSA_STRERR_API void WSAErrorLogStop(void);
 
-extern WSAERROR_API int nwsaerror;
+/* 记录一次错误, pszTag最多保留23个字符. 成功返回0; 未启动或队列已满(计入丢弃数)时返回-1 */
+WSA_STRERR_API int WSAErrorLogPush(unsigned long ulErrno, unsigned long long ullContext, const char* pszTag);
 
-WSAERROR_API int fnwsaerror(void);
+/* 本次启动以来因队列已满而丢弃的记录数 */
+WSA_STRERR_API unsigned long long WSAErrorLogDropped(void);
@@ -0,0 +1,193 @@
+﻿#include "pch.h"
+#include "wsa_error.h"
+#include "wsa_error_stats.h"
+#include "wsa_error_table.h"
+
+#include <cstdint>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define WSA_STRERR_SSE2 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define WSA_STRERR_TARGET_AVX2
+#else
+#define WSA_STRERR_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+/* The SIMD paths classify codes in 32-bit lanes, every range bound must fit */
+static_assert(wsa_strerr::codeRanges.back().first + wsa_strerr::codeRanges.back().count
+	<= std::numeric_limits<std::uint32_t>::max(), "code ranges must fit in 32 bits");
+static_assert(wsa_strerr::slotCount <= std::numeric_limits<std::int32_t>::max(), "slots must fit in 32 bits");
+
+namespace
+{
+	void TranslateScalar(const unsigned long* pCodes, size_t n, const char** ppOut)
+	{
+		for (size_t i = 0; i < n; ++i)
+		{
+			ppOut[i] = wsa_strerr::errStrTable[wsa_strerr::SlotOf(pCodes[i])];
+		}
+	}
+
+#ifdef WSA_STRERR_SSE2
+	/* Slots of the codes that fall in range I, zero elsewhere. SSE2 has no unsigned compare:
+	   flipping the sign bit of both sides makes the signed one do the job */
+	template <std::size_t I>
+	__m128i RangeSlots(__m128i codes)
+	{
+		constexpr auto range = wsa_strerr::codeRanges[I];
+		__m128i offset = _mm_sub_epi32(codes, _mm_set1_epi32(static_cast<int>(range.first)));
+		__m128i inRange = _mm_cmplt_epi32(_mm_xor_si128(offset, _mm_set1_epi32(INT32_MIN)),
+			_mm_set1_epi32(static_cast<int>(range.count ^ 0x80000000u)));
+		return _mm_and_si128(inRange, _mm_add_epi32(offset, _mm_set1_epi32(static_cast<int>(range.base))));
+	}
+
+	template <std::size_t... I>
+	__m128i SlotsOf(__m128i codes, std::index_sequence<I...>)
+	{
+		__m128i slots = _mm_setzero_si128();
+		((slots = _mm_or_si128(slots, RangeSlots<I>(codes))), ...);
+		return slots;
+	}
+
+	/* Load four codes as 32-bit lanes; on LP64 a code with high bits set becomes 0xffffffff, a miss */
+	__m128i LoadCodes4(const unsigned long* pCodes)
+	{
+		if constexpr (sizeof(unsigned long) == 4)
+		{
+			return _mm_loadu_si128(reinterpret_cast<const __m128i*>(pCodes));
+		}
+		else
+		{
+			__m128 a = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pCodes)));
+			__m128 b = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pCodes + 2)));
+			__m128i low = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+			__m128i high = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+			__m128i wide = _mm_xor_si128(_mm_cmpeq_epi32(high, _mm_setzero_si128()), _mm_set1_epi32(-1));
+			return _mm_or_si128(low, wide);
+		}
+	}
+
+	void TranslateSse2(const unsigned long* pCodes, size_t n, const char** ppOut)
+	{
+		alignas(16) std::uint32_t slots[4];
+		size_t i = 0;
+		for (; i + 4 <= n; i += 4)
+		{
+			__m128i codes = LoadCodes4(pCodes + i);
+			_mm_store_si128(reinterpret_cast<__m128i*>(slots),
+				SlotsOf(codes, std::make_index_sequence<wsa_strerr::codeRanges.size()>{}));
+			ppOut[i] = wsa_strerr::errStrTable[slots[0]];
+			ppOut[i + 1] = wsa_strerr::errStrTable[slots[1]];
+			ppOut[i + 2] = wsa_strerr::errStrTable[slots[2]];
+			ppOut[i + 3] = wsa_strerr::errStrTable[slots[3]];
+		}
+		TranslateScalar(pCodes + i, n - i, ppOut + i);
+	}
+
+	template <std::size_t I>
+	WSA_STRERR_TARGET_AVX2 __m256i RangeSlots(__m256i codes)
+	{
+		constexpr auto range = wsa_strerr::codeRanges[I];
+		__m256i offset = _mm256_sub_epi32(codes, _mm256_set1_epi32(static_cast<int>(range.first)));
+		__m256i inRange = _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(range.count ^ 0x80000000u)),
+			_mm256_xor_si256(offset, _mm256_set1_epi32(INT32_MIN)));
+		return _mm256_and_si256(inRange, _mm256_add_epi32(offset, _mm256_set1_epi32(static_cast<int>(range.base))));
+	}
+
+	template <std::size_t... I>
+	WSA_STRERR_TARGET_AVX2 __m256i SlotsOf(__m256i codes, std::index_sequence<I...>)
+	{
+		__m256i slots = _mm256_setzero_si256();
+		((slots = _mm256_or_si256(slots, RangeSlots<I>(codes))), ...);
+		return slots;
+	}
+
+	WSA_STRERR_TARGET_AVX2 __m256i LoadCodes8(const unsigned long* pCodes)
+	{
+		if constexpr (sizeof(unsigned long) == 4)
+		{
+			return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pCodes));
+		}
+		else
+		{
+			/* gather the low dwords of eight 64-bit codes into one register, high dwords into another */
+			const __m256i split = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+			__m256i a = _mm256_permutevar8x32_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pCodes)), split);
+			__m256i b = _mm256_permutevar8x32_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pCodes + 4)), split);
+			__m256i low = _mm256_permute2x128_si256(a, b, 0x20);
+			__m256i high = _mm256_permute2x128_si256(a, b, 0x31);
+			__m256i wide = _mm256_xor_si256(_mm256_cmpeq_epi32(high, _mm256_setzero_si256()), _mm256_set1_epi32(-1));
+			return _mm256_or_si256(low, wide);
+		}
+	}
+
+	WSA_STRERR_TARGET_AVX2 void TranslateAvx2(const unsigned long* pCodes, size_t n, const char** ppOut)
+	{
+		alignas(32) std::uint32_t slots[8];
+		size_t i = 0;
+		for (; i + 8 <= n; i += 8)
+		{
+			__m256i codes = LoadCodes8(pCodes + i);
+			_mm256_store_si256(reinterpret_cast<__m256i*>(slots),
+				SlotsOf(codes, std::make_index_sequence<wsa_strerr::codeRanges.size()>{}));
+			for (size_t lane = 0; lane < 8; ++lane)
+			{
+				ppOut[i + lane] = wsa_strerr::errStrTable[slots[lane]];
+			}
+		}
+		TranslateSse2(pCodes + i, n - i, ppOut + i);
+	}
+
+	bool HasAvx2()
+	{
+#if defined(_MSC_VER) && !defined(__clang__)
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+		{
+			return false;
+		}
+		__cpuid(info, 1);
+		bool osxsave = (info[2] & (1 << 27)) != 0;
+		bool avx = (info[2] & (1 << 28)) != 0;
+		if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+		{
+			return false;
+		}
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+#else
+		return __builtin_cpu_supports("avx2");
+#endif
+	}
+#endif // WSA_STRERR_SSE2
+}
+
+WSA_STRERR_API void WSAStrErrorBatch(const unsigned long* pCodes, size_t n, const char** ppOut)
+{
+#ifdef WSA_STRERR_SSE2
+	static const bool hasAvx2 = HasAvx2();
+	if (hasAvx2)
+	{
+		TranslateAvx2(pCodes, n, ppOut);
+	}
+	else
+	{
+		TranslateSse2(pCodes, n, ppOut);
+	}
+#else
+	TranslateScalar(pCodes, n, ppOut);
+#endif
+	/* counted apart from the translation, the SIMD paths never see a slot index */
+	if (wsa_strerr::countLookups.load(std::memory_order_relaxed))
+	{
+		for (size_t i = 0; i < n; ++i)
+		{
+			wsa_strerr::RecordSlot(wsa_strerr::SlotOf(pCodes[i]));
+		}
+	}
+}
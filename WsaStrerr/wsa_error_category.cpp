@@ -0,0 +1,85 @@
+﻿#include "pch.h"
+#include "wsa_error_category.h"
+#include "wsa_error_errc.h"
+#include "wsa_error_table.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace
+{
+	constexpr std::size_t Length(const char* psz)
+	{
+		std::size_t length = 0;
+		while (psz[length] != '\0')
+		{
+			++length;
+		}
+		return length;
+	}
+
+	constexpr std::array<std::uint8_t, wsa_strerr::slotCount> MakeLengthTable()
+	{
+		std::array<std::uint8_t, wsa_strerr::slotCount> table{};
+		for (std::size_t slot = 0; slot < table.size(); ++slot)
+		{
+			table[slot] = static_cast<std::uint8_t>(Length(wsa_strerr::errStrTable[slot]));
+		}
+		return table;
+	}
+
+	constexpr bool MessagesFitLengthTable()
+	{
+		for (const char* message : wsa_strerr::errStrTable)
+		{
+			if (Length(message) > UINT8_MAX)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	static_assert(MessagesFitLengthTable(), "message lengths are stored in 8 bits");
+
+	/* 每条简短描述的长度, 构造string_view只需多读一次表, 不用strlen */
+	constexpr auto messageLengths = MakeLengthTable();
+
+	class WsaCategory final : public std::error_category
+	{
+	public:
+		const char* name() const noexcept override
+		{
+			return "wsa";
+		}
+
+		std::string message(int iErrno) const override
+		{
+			return std::string(wsa_strerr::wsa_message(iErrno));
+		}
+
+		std::error_condition default_error_condition(int iErrno) const noexcept override
+		{
+			int errc = wsa_strerr::LookupErrc(static_cast<unsigned long>(iErrno));
+			return errc != 0 ? std::make_error_condition(static_cast<std::errc>(errc)) : std::error_condition(iErrno, *this);
+		}
+	};
+}
+
+namespace wsa_strerr
+{
+	const std::error_category& wsa_category() noexcept
+	{
+		/* 并非所有标准库的std::error_category构造函数都是constexpr(MSVC的不是), 命名空间作用域的对象
+		   可能在动态初始化之前就被使用; 函数内的静态对象在第一次使用时初始化, 其他静态对象的初始化中调用也没有问题 */
+		static const WsaCategory category{};
+		return category;
+	}
+
+	std::string_view wsa_message(int iErrno) noexcept
+	{
+		std::size_t slot = SlotOf(static_cast<unsigned long>(iErrno));
+		return std::string_view(errStrTable[slot], messageLengths[slot]);
+	}
+}
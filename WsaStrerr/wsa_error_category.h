@@ -0,0 +1,41 @@
+﻿// wsa_error_category.h: 把WSA错误码接入C++的std::error_code
+// 用法:
+//     std::error_code ec = wsa_strerr::make_error_code(static_cast<wsa_strerr::wsa_errc>(WSAGetLastError()));
+//     if (ec == std::errc::connection_reset) { ... }      /* 不需要比较字符串 */
+//     log(wsa_strerr::wsa_message(ec.value()));           /* 不分配内存 */
+#pragma once
+
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+#include "wsa_error.h"
+
+namespace wsa_strerr
+{
+	/* WSA错误码, 例如static_cast<wsa_errc>(WSAECONNRESET), 用于构造std::error_code */
+	enum class wsa_errc : int
+	{
+	};
+
+	/* WSA错误码的error_category, 整个进程只有一个实例(在DLL中).
+	 * name()为"wsa"; message()与WSAStrError相同; default_error_condition()把有POSIX对应的错误码映射到std::errc,
+	 * 例如WSAECONNRESET对应std::errc::connection_reset, 其余错误码的condition仍属于本category */
+	WSAERROR_API const std::error_category& wsa_category() noexcept;
+
+	/* 与WSAStrError相同的描述信息, 指向静态只读的字符串, 不分配内存, 未知错误码返回"Unknown error" */
+	WSAERROR_API std::string_view wsa_message(int iErrno) noexcept;
+
+	inline std::error_code make_error_code(wsa_errc eErrno) noexcept
+	{
+		return std::error_code(static_cast<int>(eErrno), wsa_category());
+	}
+}
+
+namespace std
+{
+	template <>
+	struct is_error_code_enum<wsa_strerr::wsa_errc> : true_type
+	{
+	};
+}
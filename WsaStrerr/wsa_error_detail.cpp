@@ -0,0 +1,99 @@
+﻿#include "pch.h"
+#include "wsa_error.h"
+#include "wsa_error_table.h"
+
+#include <array>
+#include <cstdint>
+#include <iterator>
+
+/* The full descriptions are cold data, generated from the same list as the short messages but
+   kept out of wsa_error_table.h: one contiguous read-only pool of NUL-separated strings and a
+   slot-indexed table of 16-bit offsets into it, both private to this file. Nothing on the
+   WSAStrError path ever touches them. */
+namespace
+{
+	/* offset 0 is the text for codes without an entry, the descriptions follow in list order */
+	constexpr char detailPool[] =
+		"Unknown error" "\0"
+#define WSA_ERROR_ENTRY(code, message, detail) detail "\0"
+#include "wsa_error_list.h"
+#undef WSA_ERROR_ENTRY
+		;
+
+	/* sizeof of each description literal, terminating NUL included */
+	constexpr std::size_t detailSizes[] = {
+#define WSA_ERROR_ENTRY(code, message, detail) sizeof(detail),
+#include "wsa_error_list.h"
+#undef WSA_ERROR_ENTRY
+	};
+
+	static_assert(std::size(detailSizes) == wsa_strerr::entryCount, "one description per entry");
+	static_assert(sizeof(detailPool) <= UINT16_MAX, "detail offsets are 16-bit");
+
+	constexpr std::array<std::uint16_t, std::size(detailSizes)> MakeEntryOffsets()
+	{
+		std::array<std::uint16_t, std::size(detailSizes)> offsets{};
+		std::size_t offset = sizeof("Unknown error");
+		for (std::size_t i = 0; i < offsets.size(); ++i)
+		{
+			offsets[i] = static_cast<std::uint16_t>(offset);
+			offset += detailSizes[i];
+		}
+		return offsets;
+	}
+
+	constexpr auto entryOffsets = MakeEntryOffsets();
+
+	static_assert(entryOffsets.back() + detailSizes[std::size(detailSizes) - 1] + 1 == sizeof(detailPool),
+		"descriptions must not contain embedded NULs");
+
+	constexpr bool SameText(const char* a, const char* b)
+	{
+		while (*a != '\0' && *a == *b)
+		{
+			++a;
+			++b;
+		}
+		return *a == *b;
+	}
+
+	/* Catches descriptions left empty or pasted from a neighbouring entry */
+	constexpr bool DetailsAreDistinct()
+	{
+		for (std::size_t i = 0; i < std::size(detailSizes); ++i)
+		{
+			if (detailSizes[i] <= 1)
+			{
+				return false;
+			}
+			for (std::size_t j = 0; j < i; ++j)
+			{
+				if (detailSizes[i] == detailSizes[j] && SameText(detailPool + entryOffsets[i], detailPool + entryOffsets[j]))
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	static_assert(DetailsAreDistinct(), "every entry needs its own non-empty description");
+
+	constexpr std::array<std::uint16_t, wsa_strerr::slotCount> MakeDetailOffsets()
+	{
+		std::array<std::uint16_t, wsa_strerr::slotCount> offsets{};
+		for (std::size_t i = 0; i < wsa_strerr::entryCount; ++i)
+		{
+			offsets[wsa_strerr::SlotOf(wsa_strerr::errorEntries[i].code)] = entryOffsets[i];
+		}
+		return offsets;
+	}
+
+	/* holes and slot 0 keep offset 0, "Unknown error" */
+	constexpr auto detailOffsets = MakeDetailOffsets();
+}
+
+WSA_STRERR_API const char* WSAStrErrorDetail(unsigned long ulErrno)
+{
+	return detailPool + detailOffsets[wsa_strerr::SlotOf(ulErrno)];
+}
@@ -0,0 +1,227 @@
+﻿// wsa_error_errc.h: portable std::errc and errno equivalents of the WSA error codes.
+// Only codes with a genuine POSIX counterpart are listed; the rest (the resolver and QoS codes,
+// ...) have no generic condition. The pairs are folded into a slot-indexed table next to
+// errStrTable, so mapping a code is the same SlotOf plus one load. The reverse direction is a
+// table indexed by errno value.
+#pragma once
+
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <system_error>
+
+#include "wsa_error_table.h"
+
+namespace wsa_strerr
+{
+	struct WsaErrcEntry
+	{
+		unsigned long code;
+		std::errc condition;
+	};
+
+	inline constexpr WsaErrcEntry errcEntries[] = {
+		{WSAEINTR, std::errc::interrupted},
+		{WSAEBADF, std::errc::bad_file_descriptor},
+		{WSAEACCES, std::errc::permission_denied},
+		{WSAEFAULT, std::errc::bad_address},
+		{WSAEINVAL, std::errc::invalid_argument},
+		{WSAEMFILE, std::errc::too_many_files_open},
+		{WSAEWOULDBLOCK, std::errc::operation_would_block},
+		{WSAEINPROGRESS, std::errc::operation_in_progress},
+		{WSAEALREADY, std::errc::connection_already_in_progress},
+		{WSAENOTSOCK, std::errc::not_a_socket},
+		{WSAEDESTADDRREQ, std::errc::destination_address_required},
+		{WSAEMSGSIZE, std::errc::message_size},
+		{WSAEPROTOTYPE, std::errc::wrong_protocol_type},
+		{WSAENOPROTOOPT, std::errc::no_protocol_option},
+		{WSAEPROTONOSUPPORT, std::errc::protocol_not_supported},
+		{WSAEOPNOTSUPP, std::errc::operation_not_supported},
+		{WSAEAFNOSUPPORT, std::errc::address_family_not_supported},
+		{WSAEADDRINUSE, std::errc::address_in_use},
+		{WSAEADDRNOTAVAIL, std::errc::address_not_available},
+		{WSAENETDOWN, std::errc::network_down},
+		{WSAENETUNREACH, std::errc::network_unreachable},
+		{WSAENETRESET, std::errc::network_reset},
+		{WSAECONNABORTED, std::errc::connection_aborted},
+		{WSAECONNRESET, std::errc::connection_reset},
+		{WSAENOBUFS, std::errc::no_buffer_space},
+		{WSAEISCONN, std::errc::already_connected},
+		{WSAENOTCONN, std::errc::not_connected},
+		{WSAETIMEDOUT, std::errc::timed_out},
+		{WSAECONNREFUSED, std::errc::connection_refused},
+		{WSAELOOP, std::errc::too_many_symbolic_link_levels},
+		{WSAENAMETOOLONG, std::errc::filename_too_long},
+		{WSAEHOSTUNREACH, std::errc::host_unreachable},
+		{WSAENOTEMPTY, std::errc::directory_not_empty},
+		{WSAECANCELLED, std::errc::operation_canceled},
+		{WSA_E_CANCELLED, std::errc::operation_canceled},
+		{WSA_OPERATION_ABORTED, std::errc::operation_canceled},
+		{WSA_INVALID_HANDLE, std::errc::invalid_argument},
+		{WSA_NOT_ENOUGH_MEMORY, std::errc::not_enough_memory},
+		{WSA_INVALID_PARAMETER, std::errc::invalid_argument},
+	};
+
+	constexpr bool ErrcEntriesAreValid()
+	{
+		bool used[slotCount]{};
+		for (const auto& entry : errcEntries)
+		{
+			std::size_t slot = SlotOf(entry.code);
+			if (errNameTable[slot] == nullptr || used[slot] || static_cast<int>(entry.condition) == 0)
+			{
+				return false;
+			}
+			used[slot] = true;
+		}
+		return true;
+	}
+
+	static_assert(ErrcEntriesAreValid(), "every errc pair must name a listed code, once, with a non-zero errc");
+
+	constexpr std::array<int, slotCount> MakeErrcTable()
+	{
+		std::array<int, slotCount> table{};
+		for (const auto& entry : errcEntries)
+		{
+			table[SlotOf(entry.code)] = static_cast<int>(entry.condition);
+		}
+		return table;
+	}
+
+	/* std::errc value of every slot as an int, 0 where there is no equivalent */
+	inline constexpr auto errcTable = MakeErrcTable();
+
+	constexpr int LookupErrc(unsigned long ulErrno) noexcept
+	{
+		return errcTable[SlotOf(ulErrno)];
+	}
+
+	/* Socket errnos that std::errc does not name. Not every platform has them (MSVC has none of
+	   these), so each one only takes part where <cerrno> defines it */
+	struct WsaErrnoEntry
+	{
+		unsigned long code;
+		int error;
+	};
+
+	inline constexpr WsaErrnoEntry extraErrnoEntries[] = {
+#ifdef ESOCKTNOSUPPORT
+		{WSAESOCKTNOSUPPORT, ESOCKTNOSUPPORT},
+#endif
+#ifdef EPFNOSUPPORT
+		{WSAEPFNOSUPPORT, EPFNOSUPPORT},
+#endif
+#ifdef ESHUTDOWN
+		{WSAESHUTDOWN, ESHUTDOWN},
+#endif
+#ifdef ETOOMANYREFS
+		{WSAETOOMANYREFS, ETOOMANYREFS},
+#endif
+#ifdef EHOSTDOWN
+		{WSAEHOSTDOWN, EHOSTDOWN},
+#endif
+#ifdef EPROCLIM
+		{WSAEPROCLIM, EPROCLIM},
+#endif
+#ifdef EUSERS
+		{WSAEUSERS, EUSERS},
+#endif
+#ifdef EDQUOT
+		{WSAEDQUOT, EDQUOT},
+#endif
+#ifdef ESTALE
+		{WSAESTALE, ESTALE},
+#endif
+#ifdef EREMOTE
+		{WSAEREMOTE, EREMOTE},
+#endif
+		{0, 0}, /* keeps the array non-empty, skipped below */
+	};
+
+	constexpr std::size_t MakeErrnoLimit()
+	{
+		int limit = 0;
+		for (const auto& entry : errcEntries)
+		{
+			limit = static_cast<int>(entry.condition) > limit ? static_cast<int>(entry.condition) : limit;
+		}
+		for (const auto& entry : extraErrnoEntries)
+		{
+			limit = entry.error > limit ? entry.error : limit;
+		}
+		return static_cast<std::size_t>(limit) + 1;
+	}
+
+	/* One past the largest errno that maps to a WSA code */
+	inline constexpr std::size_t errnoLimit = MakeErrnoLimit();
+
+	static_assert(errnoLimit <= 256, "errno values are stored in 8 bits");
+
+	constexpr bool ExtraErrnoEntriesAreValid()
+	{
+		for (const auto& entry : extraErrnoEntries)
+		{
+			if (entry.code != 0 && (errNameTable[SlotOf(entry.code)] == nullptr || errcTable[SlotOf(entry.code)] != 0))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	static_assert(ExtraErrnoEntriesAreValid(), "extra errno pairs must name listed codes without a std::errc");
+
+	constexpr std::array<std::uint8_t, slotCount> MakeErrnoTable()
+	{
+		std::array<std::uint8_t, slotCount> table{};
+		for (std::size_t slot = 0; slot < slotCount; ++slot)
+		{
+			table[slot] = static_cast<std::uint8_t>(errcTable[slot]);
+		}
+		for (const auto& entry : extraErrnoEntries)
+		{
+			if (entry.code != 0)
+			{
+				table[SlotOf(entry.code)] = static_cast<std::uint8_t>(entry.error);
+			}
+		}
+		return table;
+	}
+
+	/* errno of every slot, 0 where there is none */
+	inline constexpr auto errnoTable = MakeErrnoTable();
+
+	constexpr std::array<std::uint16_t, errnoLimit> MakeWsaFromErrnoTable()
+	{
+		std::array<std::uint16_t, errnoLimit> table{};
+		/* several codes share an errno (WSAEINVAL, WSA_INVALID_HANDLE and WSA_INVALID_PARAMETER are
+		   all EINVAL): the first pair wins, so errcEntries lists the canonical socket error first */
+		for (const auto& entry : errcEntries)
+		{
+			std::uint16_t& code = table[static_cast<std::size_t>(entry.condition)];
+			code = code != 0 ? code : static_cast<std::uint16_t>(entry.code);
+		}
+		for (const auto& entry : extraErrnoEntries)
+		{
+			std::uint16_t& code = table[static_cast<std::size_t>(entry.error)];
+			code = code != 0 || entry.code == 0 ? code : static_cast<std::uint16_t>(entry.code);
+		}
+		return table;
+	}
+
+	/* WSA code of every errno below errnoLimit, 0 where there is none */
+	inline constexpr auto wsaFromErrnoTable = MakeWsaFromErrnoTable();
+
+	constexpr int LookupErrno(unsigned long ulErrno) noexcept
+	{
+		return errnoTable[SlotOf(ulErrno)];
+	}
+
+	constexpr unsigned long LookupWsaFromErrno(int iErrno) noexcept
+	{
+		/* the unsigned compare also rejects negative values */
+		return static_cast<unsigned int>(iErrno) < errnoLimit ? wsaFromErrnoTable[static_cast<std::size_t>(iErrno)] : 0;
+	}
+}
@@ -0,0 +1,108 @@
+﻿// wsa_error_format.h: allocation-free formatting of error messages into caller buffers.
+// No locale, no printf family and no heap, so it is safe on hot network threads.
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+
+#include "wsa_error.h"
+#include "wsa_error_table.h"
+
+namespace wsa_strerr
+{
+	/* Appends to a fixed buffer, silently truncating; one byte is always kept for the NUL.
+	   A null buffer is treated as an empty one */
+	class BufferWriter
+	{
+	public:
+		BufferWriter(char* pBuf, std::size_t ulBufLen) noexcept
+			: begin(pBuf), pos(pBuf), end(pBuf != nullptr && ulBufLen != 0 ? pBuf + ulBufLen - 1 : pBuf),
+			terminate(pBuf != nullptr && ulBufLen != 0)
+		{
+		}
+
+		void Append(char c) noexcept
+		{
+			if (pos < end)
+			{
+				*pos++ = c;
+			}
+		}
+
+		void Append(const char* pStr) noexcept
+		{
+			std::size_t length = std::strlen(pStr);
+			std::size_t room = static_cast<std::size_t>(end - pos);
+			if (length > room)
+			{
+				length = room;
+			}
+			if (length == 0)
+			{
+				/* pos may be null for an empty buffer, and memcpy to null is undefined even for 0 bytes */
+				return;
+			}
+			std::memcpy(pos, pStr, length);
+			pos += length;
+		}
+
+		void AppendUnsigned(unsigned long long value) noexcept
+		{
+			char digits[20];
+			std::size_t count = 0;
+			do
+			{
+				digits[count++] = static_cast<char>('0' + value % 10);
+				value /= 10;
+			} while (value != 0);
+			while (count != 0 && pos < end)
+			{
+				*pos++ = digits[--count];
+			}
+		}
+
+		/* NUL-terminate (unless the buffer is empty) and return the length written */
+		std::size_t Finish() noexcept
+		{
+			if (terminate)
+			{
+				*pos = '\0';
+			}
+			return static_cast<std::size_t>(pos - begin);
+		}
+
+	private:
+		char* begin;
+		char* pos;
+		char* end;
+		bool terminate;
+	};
+
+	/* "<message>[ (<name> <code>)]", the parenthesis holds whatever uFlags asks for */
+	inline void AppendError(BufferWriter& writer, unsigned long ulErrno, unsigned int uFlags) noexcept
+	{
+		std::size_t slot = SlotOf(ulErrno);
+		writer.Append(errStrTable[slot]);
+
+		const char* pName = (uFlags & WSA_STRERR_WITH_NAME) ? errNameTable[slot] : nullptr;
+		bool withCode = (uFlags & WSA_STRERR_WITH_CODE) != 0;
+		if (pName == nullptr && !withCode)
+		{
+			return;
+		}
+		writer.Append(" (");
+		if (pName != nullptr)
+		{
+			writer.Append(pName);
+			if (withCode)
+			{
+				writer.Append(' ');
+			}
+		}
+		if (withCode)
+		{
+			writer.AppendUnsigned(ulErrno);
+		}
+		writer.Append(')');
+	}
+}
@@ -0,0 +1,539 @@
+﻿#include "pch.h"
+#include "wsa_error.h"
+#include "wsa_error_format.h"
+#include "wsa_error_log.h"
+#include "wsa_error_table.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <new>
+#include <system_error>
+#include <thread>
+
+/* Hot threads hand fixed-size records to a bounded lock-free multi-producer ring (Vyukov's
+   sequence-numbered queue) and return immediately. One background thread drains the ring,
+   formats the lines, rate-limits repeated codes and writes them out in batches. */
+namespace
+{
+	constexpr std::size_t cacheLineSize = 64;
+	constexpr std::size_t tagSize = 24;
+	constexpr std::size_t defaultCapacity = 4096;
+	constexpr std::size_t maxCapacity = 1u << 20;   /* 64 MB of records */
+	constexpr unsigned int defaultFlushIntervalMs = 1000;
+	constexpr unsigned int maxDrainPeriodMs = 5;
+	constexpr std::size_t batchSize = 64 * 1024;
+	constexpr std::size_t lineSize = 256;
+
+	struct alignas(cacheLineSize) LogRecord
+	{
+		std::atomic<std::size_t> sequence;
+		std::uint64_t timestamp;   /* ns since 1970-01-01 UTC */
+		unsigned long long context;
+		unsigned long code;
+		char tag[tagSize];
+	};
+
+	/* Everything a push touches besides its record lives on one cache line. gate counts pushes
+	   in flight, its top bit is set while the log is stopped; ring and mask only change then.
+	   writerIdle is set while the writer sleeps on an empty ring, the push that clears it wakes it. */
+	struct alignas(cacheLineSize) ProducerSide
+	{
+		std::atomic<std::uint32_t> gate{gateClosed};
+		std::atomic<std::size_t> enqueuePos{0};
+		std::atomic<bool> writerIdle{false};
+		LogRecord* ring = nullptr;
+		std::size_t mask = 0;
+
+		static constexpr std::uint32_t gateClosed = 0x80000000u;
+	};
+
+	ProducerSide producer;
+	std::atomic<unsigned long long> dropped{0};
+
+	/* Owned by WSAErrorLogStart/WSAErrorLogStop (under controlMutex) and by the writer thread */
+	struct LogState
+	{
+		std::size_t dequeuePos = 0;
+
+		FILE* file = nullptr;
+		WSAErrorLogCallback pfnCallback = nullptr;
+		void* pContext = nullptr;
+		unsigned int flushIntervalMs = defaultFlushIntervalMs;
+		unsigned int maxPerCode = 0;
+
+		/* rate limiting, per slot of the lookup table for the current flush interval */
+		unsigned int emitted[wsa_strerr::slotCount];
+		unsigned long long suppressed[wsa_strerr::slotCount];
+		unsigned long lastCode[wsa_strerr::slotCount];
+
+		char batch[batchSize];
+		std::size_t batchLength = 0;
+
+		std::thread* worker = nullptr;
+		bool stopping = false;
+		std::mutex wakeMutex;
+		std::condition_variable wake;
+	};
+
+	/* Created by the first WSAErrorLogStart, so loading the DLL costs no heap; never destroyed, a
+	   writer thread left running at exit must not see it torn down */
+	LogState* state = nullptr;
+	std::mutex controlMutex;
+
+	std::uint64_t WallClockNs() noexcept
+	{
+		using namespace std::chrono;
+		return static_cast<std::uint64_t>(duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count());
+	}
+
+	bool Enqueue(unsigned long ulErrno, unsigned long long ullContext, const char* pszTag) noexcept
+	{
+		std::size_t pos = producer.enqueuePos.load(std::memory_order_relaxed);
+		LogRecord* record;
+		for (;;)
+		{
+			record = &producer.ring[pos & producer.mask];
+			std::size_t sequence = record->sequence.load(std::memory_order_acquire);
+			auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+			if (diff == 0)
+			{
+				if (producer.enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if (diff < 0)
+			{
+				return false;   /* the slot still holds a record from the previous lap: full */
+			}
+			else
+			{
+				pos = producer.enqueuePos.load(std::memory_order_relaxed);
+			}
+		}
+
+		record->timestamp = WallClockNs();
+		record->context = ullContext;
+		record->code = ulErrno;
+		std::size_t i = 0;
+		if (pszTag != nullptr)
+		{
+			for (; i + 1 < tagSize && pszTag[i] != '\0'; ++i)
+			{
+				record->tag[i] = pszTag[i];
+			}
+		}
+		record->tag[i] = '\0';
+		record->sequence.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	/* Single consumer: only the writer thread */
+	bool RecordReady() noexcept
+	{
+		return producer.ring[state->dequeuePos & producer.mask].sequence.load(std::memory_order_acquire)
+			== state->dequeuePos + 1;
+	}
+
+	bool Dequeue(LogRecord& out) noexcept
+	{
+		if (!RecordReady())
+		{
+			return false;
+		}
+		LogRecord* record = &producer.ring[state->dequeuePos & producer.mask];
+		out.timestamp = record->timestamp;
+		out.context = record->context;
+		out.code = record->code;
+		std::copy(record->tag, record->tag + tagSize, out.tag);
+		record->sequence.store(state->dequeuePos + producer.mask + 1, std::memory_order_release);
+		++state->dequeuePos;
+		return true;
+	}
+
+	void FlushBatch() noexcept
+	{
+		if (state->batchLength == 0)
+		{
+			return;
+		}
+		if (state->file != nullptr)
+		{
+			std::fwrite(state->batch, 1, state->batchLength, state->file);
+			std::fflush(state->file);
+		}
+		else if (state->pfnCallback != nullptr)
+		{
+			state->pfnCallback(state->batch, state->batchLength, state->pContext);
+		}
+		state->batchLength = 0;
+	}
+
+	void AppendLine(const char* pLine, std::size_t length) noexcept
+	{
+		if (state->batchLength + length > batchSize)
+		{
+			FlushBatch();
+		}
+		std::copy(pLine, pLine + length, state->batch + state->batchLength);
+		state->batchLength += length;
+	}
+
+	void AppendPadded(wsa_strerr::BufferWriter& writer, unsigned int value, unsigned int width) noexcept
+	{
+		char digits[10];
+		for (unsigned int i = width; i-- > 0;)
+		{
+			digits[i] = static_cast<char>('0' + value % 10);
+			value /= 10;
+		}
+		for (unsigned int i = 0; i < width; ++i)
+		{
+			writer.Append(digits[i]);
+		}
+	}
+
+	/* ISO 8601 UTC, "2022-03-04T05:06:07.123456Z", without gmtime or locale */
+	void AppendTimestamp(wsa_strerr::BufferWriter& writer, std::uint64_t ns) noexcept
+	{
+		std::uint64_t seconds = ns / 1000000000u;
+		auto days = static_cast<std::int64_t>(seconds / 86400);
+		auto secondOfDay = static_cast<unsigned int>(seconds % 86400);
+
+		/* civil date from days since the epoch, H. Hinnant's days_from_civil inverted */
+		std::int64_t z = days + 719468;
+		std::int64_t era = z / 146097;
+		auto dayOfEra = static_cast<unsigned int>(z - era * 146097);
+		unsigned int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+		unsigned int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+		unsigned int mp = (5 * dayOfYear + 2) / 153;
+		unsigned int day = dayOfYear - (153 * mp + 2) / 5 + 1;
+		unsigned int month = mp < 10 ? mp + 3 : mp - 9;
+		auto year = static_cast<unsigned int>(yearOfEra + era * 400 + (month <= 2 ? 1 : 0));
+
+		AppendPadded(writer, year, 4);
+		writer.Append('-');
+		AppendPadded(writer, month, 2);
+		writer.Append('-');
+		AppendPadded(writer, day, 2);
+		writer.Append('T');
+		AppendPadded(writer, secondOfDay / 3600, 2);
+		writer.Append(':');
+		AppendPadded(writer, secondOfDay / 60 % 60, 2);
+		writer.Append(':');
+		AppendPadded(writer, secondOfDay % 60, 2);
+		writer.Append('.');
+		AppendPadded(writer, static_cast<unsigned int>(ns % 1000000000u / 1000), 6);
+		writer.Append('Z');
+	}
+
+	/* "<time> [<tag>] ctx=<context> <message> (<name> <code>)" */
+	void WriteRecord(const LogRecord& record) noexcept
+	{
+		std::size_t slot = wsa_strerr::SlotOf(record.code);
+		state->lastCode[slot] = record.code;
+		if (state->maxPerCode != 0 && state->emitted[slot] >= state->maxPerCode)
+		{
+			++state->suppressed[slot];
+			return;
+		}
+		++state->emitted[slot];
+
+		char line[lineSize];
+		wsa_strerr::BufferWriter writer(line, sizeof(line) - 1);
+		AppendTimestamp(writer, record.timestamp);
+		if (record.tag[0] != '\0')
+		{
+			writer.Append(" [");
+			writer.Append(record.tag);
+			writer.Append(']');
+		}
+		writer.Append(" ctx=");
+		writer.AppendUnsigned(record.context);
+		writer.Append(' ');
+		wsa_strerr::AppendError(writer, record.code, WSA_STRERR_WITH_NAME | WSA_STRERR_WITH_CODE);
+		std::size_t length = writer.Finish();
+		line[length++] = '\n';
+		AppendLine(line, length);
+	}
+
+	/* Close the rate-limiting window: one summary line per code that went over the limit */
+	void EndInterval() noexcept
+	{
+		std::uint64_t now = WallClockNs();
+		for (std::size_t slot = 0; slot < wsa_strerr::slotCount; ++slot)
+		{
+			if (state->suppressed[slot] != 0)
+			{
+				char line[lineSize];
+				wsa_strerr::BufferWriter writer(line, sizeof(line) - 1);
+				AppendTimestamp(writer, now);
+				writer.Append(' ');
+				wsa_strerr::AppendError(writer, state->lastCode[slot], WSA_STRERR_WITH_NAME | WSA_STRERR_WITH_CODE);
+				writer.Append(" repeated ");
+				writer.AppendUnsigned(state->suppressed[slot]);
+				writer.Append(slot == 0 ? " more times (unknown codes, rate limited)" : " more times (rate limited)");
+				std::size_t length = writer.Finish();
+				line[length++] = '\n';
+				AppendLine(line, length);
+			}
+			state->emitted[slot] = 0;
+			state->suppressed[slot] = 0;
+		}
+		FlushBatch();
+	}
+
+	bool DrainRing() noexcept
+	{
+		bool drained = false;
+		LogRecord record;
+		while (Dequeue(record))
+		{
+			WriteRecord(record);
+			drained = true;
+		}
+		return drained;
+	}
+
+	/* While records keep arriving the writer drains every drainPeriod, so a burst goes out in few
+	   writes. Once a drain finds the ring empty it sleeps until a push wakes it, or until the end
+	   of the flush interval if that still has lines or rate-limit counts to write. */
+	void WriterThread()
+	{
+		using clock = std::chrono::steady_clock;
+		auto drainPeriod = std::chrono::milliseconds(std::min(state->flushIntervalMs, maxDrainPeriodMs));
+		auto interval = std::chrono::milliseconds(state->flushIntervalMs);
+		auto intervalEnd = clock::now() + interval;
+		auto awake = []() { return state->stopping || !producer.writerIdle.load(std::memory_order_relaxed); };
+		bool pending = false;
+
+		std::unique_lock<std::mutex> lock(state->wakeMutex);
+		for (;;)
+		{
+			bool stop = state->stopping;
+			lock.unlock();
+
+			bool drained = DrainRing();
+			pending = pending || drained;
+			if (stop || (pending && clock::now() >= intervalEnd))
+			{
+				EndInterval();
+				pending = false;
+				intervalEnd = clock::now() + interval;
+			}
+
+			lock.lock();
+			if (stop)
+			{
+				break;
+			}
+			if (drained)
+			{
+				state->wake.wait_for(lock, drainPeriod, []() { return state->stopping; });
+				continue;
+			}
+
+			/* announce the sleep before the last look at the ring; pairs with the fence in WSAErrorLogPush */
+			producer.writerIdle.store(true, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (!RecordReady())
+			{
+				if (pending)
+				{
+					state->wake.wait_until(lock, intervalEnd, awake);
+				}
+				else
+				{
+					state->wake.wait(lock, awake);
+					intervalEnd = clock::now() + interval;
+				}
+			}
+			producer.writerIdle.store(false, std::memory_order_relaxed);
+		}
+	}
+
+	void ReleaseResources() noexcept
+	{
+		if (state->file != nullptr)
+		{
+			std::fclose(state->file);
+			state->file = nullptr;
+		}
+		delete[] producer.ring;
+		producer.ring = nullptr;
+	}
+}
+
+WSA_STRERR_API int WSAErrorLogStart(const WSAErrorLogConfig* pConfig)
+{
+	std::lock_guard<std::mutex> control(controlMutex);
+	if ((state != nullptr && state->worker != nullptr) || pConfig == nullptr
+		|| (pConfig->pszFilePath == nullptr) == (pConfig->pfnCallback == nullptr))
+	{
+		return -1;
+	}
+
+	std::size_t capacity = pConfig->uCapacity ? pConfig->uCapacity : defaultCapacity;
+	if (capacity > maxCapacity)
+	{
+		return -1;
+	}
+	std::size_t ringSize = 2;
+	while (ringSize < capacity)
+	{
+		ringSize <<= 1;
+	}
+	if (state == nullptr)
+	{
+		state = new (std::nothrow) LogState();
+		if (state == nullptr)
+		{
+			return -1;
+		}
+#if defined(_WIN32)
+		/* Pin the DLL until the process exits. A reference dropped by WSAErrorLogStop could be the
+		   last one, unmapping the code Stop returns into, and the writer thread cannot drop it either
+		   before Stop is done with the DLL. */
+		HMODULE hSelf = nullptr;
+		GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_PIN,
+			reinterpret_cast<LPCWSTR>(&WSAErrorLogStart), &hSelf);
+#endif
+	}
+
+	if (pConfig->pszFilePath != nullptr)
+	{
+#if defined(_MSC_VER)
+		if (fopen_s(&state->file, pConfig->pszFilePath, "ab") != 0)
+		{
+			state->file = nullptr;
+		}
+#else
+		state->file = std::fopen(pConfig->pszFilePath, "ab");
+#endif
+		if (state->file == nullptr)
+		{
+			return -1;
+		}
+	}
+	state->pfnCallback = pConfig->pfnCallback;
+	state->pContext = pConfig->pContext;
+	state->flushIntervalMs = pConfig->uFlushIntervalMs ? pConfig->uFlushIntervalMs : defaultFlushIntervalMs;
+	state->maxPerCode = pConfig->uMaxPerCode;
+
+	/* nothing may throw out of this export: allocation and thread creation failures roll back to -1 */
+	producer.ring = new (std::nothrow) LogRecord[ringSize];
+	if (producer.ring == nullptr)
+	{
+		ReleaseResources();
+		return -1;
+	}
+	producer.mask = ringSize - 1;
+	for (std::size_t i = 0; i < ringSize; ++i)
+	{
+		producer.ring[i].sequence.store(i, std::memory_order_relaxed);
+	}
+	state->dequeuePos = 0;
+	producer.enqueuePos.store(0, std::memory_order_relaxed);
+	dropped.store(0, std::memory_order_relaxed);
+	std::fill(std::begin(state->emitted), std::end(state->emitted), 0u);
+	std::fill(std::begin(state->suppressed), std::end(state->suppressed), 0ull);
+	state->batchLength = 0;
+	state->stopping = false;
+	producer.writerIdle.store(false, std::memory_order_relaxed);
+
+	try
+	{
+		state->worker = new std::thread(WriterThread);
+	}
+	catch (const std::exception&)
+	{
+		/* std::bad_alloc or std::system_error */
+		state->worker = nullptr;
+		ReleaseResources();
+		return -1;
+	}
+	producer.gate.fetch_and(~ProducerSide::gateClosed, std::memory_order_release);
+	return 0;
+}
+
+WSA_STRERR_API void WSAErrorLogStop(void)
+{
+	std::lock_guard<std::mutex> control(controlMutex);
+	if (state == nullptr || state->worker == nullptr)
+	{
+		return;
+	}
+
+	/* no new pushes, then wait for the ones already inside the ring to publish their record */
+	producer.gate.fetch_or(ProducerSide::gateClosed, std::memory_order_acq_rel);
+	while ((producer.gate.load(std::memory_order_acquire) & ~ProducerSide::gateClosed) != 0)
+	{
+		std::this_thread::yield();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(state->wakeMutex);
+		state->stopping = true;
+	}
+	state->wake.notify_one();
+	state->worker->join();
+	delete state->worker;
+	state->worker = nullptr;
+	ReleaseResources();
+}
+
+WSA_STRERR_API int WSAErrorLogPush(unsigned long ulErrno, unsigned long long ullContext, const char* pszTag)
+{
+	if (producer.gate.fetch_add(1, std::memory_order_acquire) & ProducerSide::gateClosed)
+	{
+		producer.gate.fetch_sub(1, std::memory_order_release);
+		return -1;
+	}
+	bool queued = Enqueue(ulErrno, ullContext, pszTag);
+	if (queued)
+	{
+		/* either the writer sees this record on its last look or this push sees it idle */
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (producer.writerIdle.load(std::memory_order_relaxed)
+			&& producer.writerIdle.exchange(false, std::memory_order_relaxed))
+		{
+			std::lock_guard<std::mutex> lock(state->wakeMutex);
+			state->wake.notify_one();
+		}
+	}
+	producer.gate.fetch_sub(1, std::memory_order_release);
+	if (!queued)
+	{
+		dropped.fetch_add(1, std::memory_order_relaxed);
+		return -1;
+	}
+	return 0;
+}
+
+WSA_STRERR_API unsigned long long WSAErrorLogDropped(void)
+{
+	return dropped.load(std::memory_order_relaxed);
+}
+
+namespace wsa_strerr
+{
+	void ErrorLogProcessDetach(bool processTerminating) noexcept
+	{
+		if (!processTerminating || state == nullptr || state->worker == nullptr)
+		{
+			return;
+		}
+		/* The writer thread was terminated with every other thread, possibly inside fwrite/fflush
+		   holding the stream lock, inside the heap, or halfway through Dequeue or AppendLine. Writing
+		   the rest of the ring would need those locks and that state, so records not yet written are
+		   lost and nothing is freed; the process is about to release it all anyway. Only the gate is
+		   closed, which is a lone atomic. */
+		producer.gate.fetch_or(ProducerSide::gateClosed, std::memory_order_acq_rel);
+		state->worker = nullptr;   /* leaked on purpose, destroying a joinable std::thread aborts */
+	}
+}
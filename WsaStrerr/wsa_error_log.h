@@ -0,0 +1,10 @@
+﻿// wsa_error_log.h: hooks of the asynchronous error log used by DllMain.
+#pragma once
+
+namespace wsa_strerr
+{
+	/* Called on DLL_PROCESS_DETACH. The first WSAErrorLogStart pins the DLL, so this only has work
+	   to do when the process is terminating: the writer thread is already gone, and the log is
+	   closed to further pushes without touching any lock, stream or heap. */
+	void ErrorLogProcessDetach(bool processTerminating) noexcept;
+}
@@ -0,0 +1,245 @@
+﻿// wsa_error_names.h: symbolic name -> error code lookup through a perfect hash.
+// The hash is built at compile time from the entry list with "hash and displace": every name is
+// hashed once from its length and first and last 8 bytes, the hash picks a bucket, and each
+// bucket gets the smallest seed that sends all of its names to still-free positions of a table
+// with about a third more positions than names. A lookup hashes the query, applies its bucket's
+// seed and confirms with a single string compare.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "wsa_error_table.h"
+
+namespace wsa_strerr
+{
+	constexpr bool IsConstantEvaluated() noexcept
+	{
+#if defined(__cpp_lib_is_constant_evaluated)
+		return std::is_constant_evaluated();
+#else
+		return __builtin_is_constant_evaluated();
+#endif
+	}
+
+	/* 8 bytes as a little-endian word: one unaligned load at run time, byte by byte while building
+	   the index (every target of this library is little-endian, so both agree) */
+	constexpr std::uint64_t LoadName8(const char* p) noexcept
+	{
+		if (IsConstantEvaluated())
+		{
+			std::uint64_t word = 0;
+			for (std::size_t i = 8; i-- > 0;)
+			{
+				word = (word << 8) | static_cast<unsigned char>(p[i]);
+			}
+			return word;
+		}
+		std::uint64_t word = 0;
+		std::memcpy(&word, p, sizeof(word));
+		return word;
+	}
+
+	/* Every name is at least 8 characters, so two loads, the first and the last 8 bytes (overlapping
+	   for names up to 15), plus the length identify it without walking the string. A shorter query
+	   cannot be a name: it hashes by length alone and the string compare rejects it */
+	constexpr std::uint64_t HashName(const char* pszName, std::size_t length) noexcept
+	{
+		if (length < 8)
+		{
+			return length * 0x9e3779b97f4a7c15ull;
+		}
+		std::uint64_t head = LoadName8(pszName);
+		std::uint64_t tail = LoadName8(pszName + length - 8);
+		std::uint64_t x = (head ^ length) * 0x9e3779b97f4a7c15ull;
+		x ^= (tail << 32 | tail >> 32) * 0xc2b2ae3d27d4eb4full;
+		x ^= x >> 29;
+		x *= 0xbf58476d1ce4e5b9ull;
+		return x ^ (x >> 32);
+	}
+
+	constexpr std::size_t NameLength(const char* pszName) noexcept
+	{
+		std::size_t length = 0;
+		while (pszName[length] != '\0')
+		{
+			++length;
+		}
+		return length;
+	}
+
+	constexpr std::uint64_t HashName(const char* pszName) noexcept
+	{
+		return HashName(pszName, NameLength(pszName));
+	}
+
+	constexpr bool NamesAreHashable()
+	{
+		std::uint64_t hashes[entryCount] = {};
+		for (std::size_t i = 0; i < entryCount; ++i)
+		{
+			if (NameLength(errorEntries[i].name) < 8)
+			{
+				return false;
+			}
+			hashes[i] = HashName(errorEntries[i].name);
+			for (std::size_t j = 0; j < i; ++j)
+			{
+				if (hashes[i] == hashes[j])
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	/* two names with one hash could never be told apart by any seed */
+	static_assert(NamesAreHashable(), "names must be at least 8 characters and hash to distinct values");
+
+	/* With 95 names in 128 positions no bucket needs a seed above 12; a table of exactly entryCount
+	   positions needed seeds up to 378 and most of the compile-time evaluation budget */
+	inline constexpr std::size_t nameTableSize = 128;
+	inline constexpr std::size_t nameBucketCount = 64;
+	inline constexpr std::uint32_t maxNameSeed = 64;
+
+	/* Position of a hash for a given seed, reduced to [0, nameTableSize) without a division */
+	constexpr std::size_t NamePosition(std::uint64_t hash, std::uint32_t seed) noexcept
+	{
+		std::uint64_t x = hash + seed * 0x9e3779b97f4a7c15ull;
+		x = (x ^ (x >> 32)) * 0xd6e8feb86659fd93ull;
+		x ^= x >> 32;
+		return static_cast<std::size_t>(((x & 0xffffffffull) * nameTableSize) >> 32);
+	}
+
+	constexpr std::size_t NameBucket(std::uint64_t hash) noexcept
+	{
+		return static_cast<std::size_t>(hash >> 58);   /* top bits, NamePosition mixes in the low ones */
+	}
+
+	static_assert(nameBucketCount == std::size_t{1} << (64 - 58), "NameBucket takes log2(nameBucketCount) bits");
+	static_assert(entryCount <= nameTableSize, "every name needs a position of its own");
+	static_assert(entryCount <= UINT8_MAX, "entry indices are stored in 8 bits");
+	static_assert(maxNameSeed <= UINT8_MAX + 1, "seeds are stored in 8 bits");
+
+	struct NameIndex
+	{
+		std::array<std::uint8_t, nameBucketCount> seeds;
+		/* position -> index into errorEntries; free positions keep entry 0, whose name the string
+		   compare then rejects */
+		std::array<std::uint8_t, nameTableSize> entries;
+		bool complete;   /* every bucket found a seed below maxNameSeed */
+	};
+
+	constexpr NameIndex MakeNameIndex()
+	{
+		/* hash every name once and group the entries by bucket (counting sort) */
+		std::array<std::uint64_t, entryCount> hashes{};
+		std::array<std::size_t, nameBucketCount + 1> bucketStart{};
+		for (std::size_t i = 0; i < entryCount; ++i)
+		{
+			hashes[i] = HashName(errorEntries[i].name);
+			++bucketStart[NameBucket(hashes[i]) + 1];
+		}
+		for (std::size_t b = 0; b < nameBucketCount; ++b)
+		{
+			bucketStart[b + 1] += bucketStart[b];
+		}
+		std::array<std::size_t, entryCount> members{};
+		std::array<std::size_t, nameBucketCount> filled{};
+		for (std::size_t i = 0; i < entryCount; ++i)
+		{
+			std::size_t b = NameBucket(hashes[i]);
+			members[bucketStart[b] + filled[b]++] = i;
+		}
+
+		/* place the fullest buckets first, while most positions are still free */
+		std::size_t largest = 0;
+		for (std::size_t b = 0; b < nameBucketCount; ++b)
+		{
+			largest = filled[b] > largest ? filled[b] : largest;
+		}
+
+		NameIndex index{};
+		index.complete = true;
+		std::array<bool, nameTableSize> used{};
+		for (std::size_t size = largest; size > 0 && index.complete; --size)
+		{
+			for (std::size_t b = 0; b < nameBucketCount && index.complete; ++b)
+			{
+				if (filled[b] != size)
+				{
+					continue;
+				}
+				std::size_t first = bucketStart[b];
+				std::size_t last = bucketStart[b + 1];
+				std::uint32_t seed = 0;
+				for (; seed < maxNameSeed; ++seed)
+				{
+					/* the bucket fits if its names land on free positions distinct from each other */
+					bool fits = true;
+					for (std::size_t m = first; m < last && fits; ++m)
+					{
+						std::size_t position = NamePosition(hashes[members[m]], seed);
+						fits = !used[position];
+						for (std::size_t k = first; k < m && fits; ++k)
+						{
+							fits = NamePosition(hashes[members[k]], seed) != position;
+						}
+					}
+					if (fits)
+					{
+						break;
+					}
+				}
+				if (seed == maxNameSeed)
+				{
+					index.complete = false;
+					break;
+				}
+				index.seeds[b] = static_cast<std::uint8_t>(seed);
+				for (std::size_t m = first; m < last; ++m)
+				{
+					std::size_t position = NamePosition(hashes[members[m]], seed);
+					used[position] = true;
+					index.entries[position] = static_cast<std::uint8_t>(members[m]);
+				}
+			}
+		}
+		return index;
+	}
+
+	inline constexpr NameIndex nameIndex = MakeNameIndex();
+
+	static_assert(nameIndex.complete, "a bucket of names needs a seed of maxNameSeed or more: "
+		"raise nameTableSize, nameBucketCount or maxNameSeed");
+
+	constexpr std::size_t NameLookupPosition(std::uint64_t hash) noexcept
+	{
+		return NamePosition(hash, nameIndex.seeds[NameBucket(hash)]);
+	}
+
+	constexpr bool NameIndexIsPerfect()
+	{
+		for (std::size_t i = 0; i < entryCount; ++i)
+		{
+			if (nameIndex.entries[NameLookupPosition(HashName(errorEntries[i].name))] != i)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	static_assert(NameIndexIsPerfect(), "every name must hash to its own entry");
+
+	/* Code of a symbolic name ("WSAECONNRESET"), 0 when the name is unknown. Case-sensitive */
+	inline unsigned long LookupCode(const char* pszName) noexcept
+	{
+		const auto& entry = errorEntries[nameIndex.entries[NameLookupPosition(HashName(pszName, std::strlen(pszName)))]];
+		return std::strcmp(entry.name, pszName) == 0 ? entry.code : 0;
+	}
+}
@@ -0,0 +1,84 @@
+﻿#include "pch.h"
+#include "wsa_error.h"
+#include "wsa_error_stats.h"
+#include "wsa_error_table.h"
+
+#include <cstdint>
+
+namespace
+{
+	/* Counters are sharded so concurrent writers do not fight over cache lines: every thread is
+	   given a shard the first time it records, round robin. With more threads than shards some
+	   threads share one, which stays correct because every update is an atomic add. */
+	constexpr std::size_t shardCount = 64;
+	constexpr std::size_t cacheLineSize = 64;
+
+	struct alignas(cacheLineSize) StatsShard
+	{
+		std::atomic<std::uint64_t> counts[wsa_strerr::slotCount];
+	};
+
+	StatsShard shards[shardCount];
+	std::atomic<std::size_t> nextShard{0};
+	thread_local StatsShard* threadShard = nullptr;
+
+	StatsShard& ThreadShard() noexcept
+	{
+		StatsShard* shard = threadShard;
+		if (shard == nullptr)
+		{
+			shard = &shards[nextShard.fetch_add(1, std::memory_order_relaxed) % shardCount];
+			threadShard = shard;
+		}
+		return *shard;
+	}
+}
+
+namespace wsa_strerr
+{
+	std::atomic<bool> countLookups{false};
+
+	void RecordSlot(std::size_t slot) noexcept
+	{
+		ThreadShard().counts[slot].fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+WSA_STRERR_API void WSARecordError(unsigned long ulErrno)
+{
+	wsa_strerr::RecordSlot(wsa_strerr::SlotOf(ulErrno));
+}
+
+WSA_STRERR_API void WSAErrorStatsCountLookups(int bEnable)
+{
+	wsa_strerr::countLookups.store(bEnable != 0, std::memory_order_relaxed);
+}
+
+WSA_STRERR_API size_t WSAErrorStatsSnapshot(WSAErrorCount* pCounts, size_t ulMaxCounts, int bReset)
+{
+	size_t total = 0;
+	for (std::size_t slot = 0; slot < wsa_strerr::slotCount; ++slot)
+	{
+		bool store = pCounts != nullptr && total < ulMaxCounts;
+		std::uint64_t count = 0;
+		for (auto& shard : shards)
+		{
+			/* exchange keeps every concurrent increment: it lands either in this snapshot or the next */
+			count += (store && bReset)
+				? shard.counts[slot].exchange(0, std::memory_order_relaxed)
+				: shard.counts[slot].load(std::memory_order_relaxed);
+		}
+		if (count == 0)
+		{
+			continue;
+		}
+		if (store)
+		{
+			/* slot 0 collects every code outside the ranges */
+			pCounts[total].ulErrno = slot != 0 ? wsa_strerr::CodeOfSlot(slot) : WSA_ERROR_STATS_OTHER;
+			pCounts[total].ullCount = count;
+		}
+		++total;
+	}
+	return total;
+}
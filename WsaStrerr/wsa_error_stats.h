@@ -0,0 +1,14 @@
+﻿// wsa_error_stats.h: per-code error counters shared by the exports in this DLL.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+namespace wsa_strerr
+{
+	/* Set by WSAErrorStatsCountLookups, WSAStrError counts the codes it translates while true */
+	extern std::atomic<bool> countLookups;
+
+	/* Count one occurrence of the code mapped to `slot` (see wsa_error_table.h) */
+	void RecordSlot(std::size_t slot) noexcept;
+}
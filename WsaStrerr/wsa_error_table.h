@@ -0,0 +1,162 @@
+﻿// wsa_error_table.h: compile-time lookup table for WSA error codes.
+// The codes cluster in a few dense ranges, so every known code is mapped to a "slot" in one flat
+// array: slot 0 means "unknown", and each range owns a contiguous run of slots after it.
+// Everything here is constexpr, so the tables live in read-only data and need no static
+// initializer, no heap and no locks. A lookup is one compare per range plus one indexed load.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+
+#include "wsa_codes.h"
+
+namespace wsa_strerr
+{
+	struct WsaErrorEntry
+	{
+		unsigned long code;
+		const char* name;
+		const char* message;
+	};
+
+	inline constexpr WsaErrorEntry errorEntries[] = {
+#define WSA_ERROR_ENTRY(code, message, detail) {static_cast<unsigned long>(code), #code, message},
+#include "wsa_error_list.h"
+#undef WSA_ERROR_ENTRY
+	};
+
+	inline constexpr std::size_t entryCount = std::size(errorEntries);
+
+	struct WsaCodeSpan
+	{
+		unsigned long first;
+		unsigned long last;
+	};
+
+	/* Ordered by how often the codes show up in practice, the 100xx range is checked first */
+	inline constexpr WsaCodeSpan codeSpans[] = {
+		{WSAEINTR, WSAEREFUSED},
+		{WSAHOST_NOT_FOUND, WSA_QOS_RESERVED_PETYPE},
+		{WSA_OPERATION_ABORTED, WSA_IO_PENDING},
+		{WSA_INVALID_HANDLE, WSA_NOT_ENOUGH_MEMORY},
+		{WSA_INVALID_PARAMETER, WSA_INVALID_PARAMETER},
+	};
+
+	struct WsaCodeRange
+	{
+		unsigned long first;
+		unsigned long count;
+		std::size_t base;
+	};
+
+	constexpr std::array<WsaCodeRange, std::size(codeSpans)> MakeCodeRanges()
+	{
+		std::array<WsaCodeRange, std::size(codeSpans)> ranges{};
+		std::size_t base = 1;
+		for (std::size_t i = 0; i < ranges.size(); ++i)
+		{
+			ranges[i].first = codeSpans[i].first;
+			ranges[i].count = codeSpans[i].last - codeSpans[i].first + 1;
+			ranges[i].base = base;
+			base += ranges[i].count;
+		}
+		return ranges;
+	}
+
+	inline constexpr auto codeRanges = MakeCodeRanges();
+
+	/* Number of slots, including the "unknown" slot 0 */
+	inline constexpr std::size_t slotCount = codeRanges.back().base + codeRanges.back().count;
+
+	template <std::size_t... I>
+	constexpr std::size_t SlotOfImpl(unsigned long ulErrno, std::index_sequence<I...>) noexcept
+	{
+		std::size_t slot = 0;
+		/* expands to one test per range with the bounds as immediates. The ranges are disjoint so
+		   at most one term is non-zero; masking instead of branching keeps mixed codes free of
+		   mispredictions, and unsigned wrap-around turns "first <= code <= last" into one compare */
+		((slot |= (std::size_t{0} - static_cast<std::size_t>(ulErrno - codeRanges[I].first < codeRanges[I].count))
+			& (codeRanges[I].base + (ulErrno - codeRanges[I].first))), ...);
+		return slot;
+	}
+
+	/* Map an error code to its slot, 0 if the code is outside every range */
+	constexpr std::size_t SlotOf(unsigned long ulErrno) noexcept
+	{
+		return SlotOfImpl(ulErrno, std::make_index_sequence<codeRanges.size()>{});
+	}
+
+	/* Inverse of SlotOf for slots other than 0 */
+	constexpr unsigned long CodeOfSlot(std::size_t slot) noexcept
+	{
+		for (const auto& range : codeRanges)
+		{
+			if (slot - range.base < range.count)
+			{
+				return range.first + static_cast<unsigned long>(slot - range.base);
+			}
+		}
+		return 0;
+	}
+
+	constexpr bool EntriesHaveDistinctSlots()
+	{
+		bool used[slotCount]{};
+		for (const auto& entry : errorEntries)
+		{
+			std::size_t slot = SlotOf(entry.code);
+			if (slot == 0 || used[slot])
+			{
+				return false;
+			}
+			used[slot] = true;
+		}
+		return true;
+	}
+
+	static_assert(EntriesHaveDistinctSlots(), "every entry must fall in a code range and appear only once");
+
+	inline constexpr char unknownError[] = "Unknown error";
+
+	constexpr std::array<const char*, slotCount> MakeMessageTable()
+	{
+		std::array<const char*, slotCount> table{};
+		for (auto& message : table)
+		{
+			message = unknownError;
+		}
+		for (const auto& entry : errorEntries)
+		{
+			table[SlotOf(entry.code)] = entry.message;
+		}
+		return table;
+	}
+
+	/* Short message of every slot, holes and slot 0 point to unknownError */
+	inline constexpr auto errStrTable = MakeMessageTable();
+
+	constexpr std::array<const char*, slotCount> MakeNameTable()
+	{
+		std::array<const char*, slotCount> table{};
+		for (const auto& entry : errorEntries)
+		{
+			table[SlotOf(entry.code)] = entry.name;
+		}
+		return table;
+	}
+
+	/* Symbolic name of every slot ("WSAECONNRESET"), nullptr for holes and slot 0 */
+	inline constexpr auto errNameTable = MakeNameTable();
+
+	constexpr const char* LookupMessage(unsigned long ulErrno) noexcept
+	{
+		return errStrTable[SlotOf(ulErrno)];
+	}
+
+	constexpr const char* LookupName(unsigned long ulErrno) noexcept
+	{
+		return errNameTable[SlotOf(ulErrno)];
+	}
+}
@@ -0,0 +1,126 @@
+﻿// annotate_map.cpp: MappedFile on Win32 file mappings and POSIX mmap.
+#include "annotate_map.h"
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace annotate
+{
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+#if defined(_WIN32)
+	int MappedFile::Open(const char* pszPath)
+	{
+		Close();
+		HANDLE hFile = CreateFileA(pszPath, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+			OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (hFile == INVALID_HANDLE_VALUE)
+		{
+			return static_cast<int>(GetLastError());
+		}
+		LARGE_INTEGER fileSize;
+		int error = 0;
+		if (!GetFileSizeEx(hFile, &fileSize))
+		{
+			error = static_cast<int>(GetLastError());
+		}
+		else if (static_cast<unsigned long long>(fileSize.QuadPart) > static_cast<std::size_t>(-1))
+		{
+			error = ERROR_FILE_TOO_LARGE; /* a 32-bit process cannot map it in one view */
+		}
+		else if (fileSize.QuadPart != 0)
+		{
+			hMapping = CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			const void* pView = hMapping != nullptr ? MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+			if (pView == nullptr)
+			{
+				error = static_cast<int>(GetLastError());
+			}
+			else
+			{
+				pData = static_cast<const char*>(pView);
+				length = static_cast<std::size_t>(fileSize.QuadPart);
+			}
+		}
+		/* the mapping keeps the file open */
+		CloseHandle(hFile);
+		if (error != 0)
+		{
+			Close();
+		}
+		return error;
+	}
+
+	void MappedFile::Close()
+	{
+		if (pData != nullptr)
+		{
+			UnmapViewOfFile(pData);
+		}
+		if (hMapping != nullptr)
+		{
+			CloseHandle(hMapping);
+		}
+		pData = nullptr;
+		length = 0;
+		hMapping = nullptr;
+	}
+#else
+	int MappedFile::Open(const char* pszPath)
+	{
+		Close();
+		int fd = open(pszPath, O_RDONLY | O_CLOEXEC);
+		if (fd < 0)
+		{
+			return errno;
+		}
+		struct stat info;
+		int error = 0;
+		if (fstat(fd, &info) != 0)
+		{
+			error = errno;
+		}
+		else if (info.st_size > 0)
+		{
+			void* pView = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+			if (pView == MAP_FAILED)
+			{
+				error = errno;
+			}
+			else
+			{
+				/* the file is read once front to back: ask for aggressive read-ahead */
+				madvise(pView, static_cast<std::size_t>(info.st_size), MADV_SEQUENTIAL);
+				pData = static_cast<const char*>(pView);
+				length = static_cast<std::size_t>(info.st_size);
+			}
+		}
+		/* the mapping keeps the file open */
+		close(fd);
+		return error;
+	}
+
+	void MappedFile::Close()
+	{
+		if (pData != nullptr)
+		{
+			munmap(const_cast<char*>(pData), length);
+		}
+		pData = nullptr;
+		length = 0;
+	}
+#endif
+}
@@ -0,0 +1,32 @@
+﻿// annotate_map.h: read-only memory mapping of a whole file.
+#pragma once
+
+#include <cstddef>
+
+namespace annotate
+{
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		~MappedFile();
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		/* Map pszPath, returns 0 or the system error code (errno, GetLastError() on Windows).
+		   An empty file maps to data() == nullptr and size() == 0. The size is fixed at Open: on
+		   POSIX, reading pages that a later truncation removed raises SIGBUS */
+		int Open(const char* pszPath);
+		void Close();
+
+		const char* data() const { return pData; }
+		std::size_t size() const { return length; }
+
+	private:
+		const char* pData = nullptr;
+		std::size_t length = 0;
+#if defined(_WIN32)
+		void* hMapping = nullptr;
+#endif
+	};
+}
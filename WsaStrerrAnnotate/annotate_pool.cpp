@@ -0,0 +1,132 @@
+﻿// annotate_pool.cpp: worker pool and the ordered output of annotated chunks.
+#include "annotate_pool.h"
+
+#include <string>
+
+namespace annotate
+{
+	WorkerPool::WorkerPool(unsigned int threads)
+	{
+		threads = threads != 0 ? threads : 1;
+		workers.reserve(threads);
+		for (unsigned int i = 0; i < threads; ++i)
+		{
+			workers.emplace_back(&WorkerPool::Work, this, i);
+		}
+	}
+
+	WorkerPool::~WorkerPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		wake.notify_all();
+		for (auto& worker : workers)
+		{
+			worker.join();
+		}
+	}
+
+	void WorkerPool::Run(std::size_t tasks, const std::function<void(std::size_t, unsigned int)>& body)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		pBody = &body;
+		taskCount = tasks;
+		nextTask.store(0, std::memory_order_relaxed);
+		busy = size();
+		++generation;
+		wake.notify_all();
+		done.wait(lock, [this] { return busy == 0; });
+		pBody = nullptr;
+	}
+
+	void WorkerPool::Work(unsigned int worker)
+	{
+		std::uint64_t seen = 0;
+		std::unique_lock<std::mutex> lock(mutex);
+		for (;;)
+		{
+			wake.wait(lock, [&] { return stopping || generation != seen; });
+			if (stopping)
+			{
+				return;
+			}
+			seen = generation;
+			const auto& body = *pBody;
+			std::size_t tasks = taskCount;
+			lock.unlock();
+			for (std::size_t task = nextTask.fetch_add(1, std::memory_order_relaxed); task < tasks;
+				task = nextTask.fetch_add(1, std::memory_order_relaxed))
+			{
+				body(task, worker);
+			}
+			lock.lock();
+			if (--busy == 0)
+			{
+				done.notify_one();
+			}
+		}
+	}
+
+	void AnnotateParallel(WorkerPool& pool, const char* pData, std::size_t size, std::size_t chunkSize, const ScanOptions& options,
+		const Annotations& annotations, const std::function<void(const char*, std::size_t)>& write)
+	{
+		std::vector<Chunk> chunks = SplitLines(pData, size, chunkSize);
+		/* chunk i is buffered in buffers[i % window] until every chunk before it has been written */
+		const std::size_t window = pool.size() * 4;
+		std::vector<std::string> buffers(window);
+		std::vector<char> ready(window, 0);
+		std::size_t nextToWrite = 0;
+		std::mutex outputMutex;
+		std::condition_variable space;
+
+		pool.Run(chunks.size(), [&](std::size_t task, unsigned int) {
+			{
+				std::unique_lock<std::mutex> lock(outputMutex);
+				space.wait(lock, [&] { return task < nextToWrite + window; });
+			}
+			std::string& buffer = buffers[task % window];
+			buffer.clear();
+			AnnotateChunk(pData, chunks[task], options, annotations, buffer);
+
+			std::lock_guard<std::mutex> lock(outputMutex);
+			ready[task % window] = 1;
+			/* whoever completes the oldest pending chunk writes it and every finished one after it */
+			while (nextToWrite < chunks.size() && ready[nextToWrite % window])
+			{
+				const std::string& text = buffers[nextToWrite % window];
+				if (!text.empty())
+				{
+					write(text.data(), text.size());
+				}
+				ready[nextToWrite % window] = 0;
+				++nextToWrite;
+			}
+			space.notify_all();
+		});
+	}
+
+	void CountParallel(WorkerPool& pool, const char* pData, std::size_t size, std::size_t chunkSize, const ScanOptions& options,
+		SlotCounts& counts)
+	{
+		/* one private set of counters per worker, on its own cache lines */
+		struct alignas(64) WorkerCounts
+		{
+			SlotCounts counts{};
+		};
+
+		std::vector<Chunk> chunks = SplitLines(pData, size, chunkSize);
+		std::vector<WorkerCounts> workerCounts(pool.size());
+		pool.Run(chunks.size(), [&](std::size_t task, unsigned int worker) {
+			CountChunk(pData, chunks[task], options, workerCounts[worker].counts);
+		});
+		for (const auto& partial : workerCounts)
+		{
+			for (std::size_t slot = 0; slot < counts.size(); ++slot)
+			{
+				counts[slot] += partial.counts[slot];
+			}
+		}
+	}
+}
@@ -0,0 +1,56 @@
+﻿// annotate_pool.h: runs the chunk scanner over a whole input on a pool of worker threads.
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "annotate_scan.h"
+
+namespace annotate
+{
+	/* Fixed set of threads that run one batch of numbered tasks at a time */
+	class WorkerPool
+	{
+	public:
+		explicit WorkerPool(unsigned int threads);
+		~WorkerPool();
+		WorkerPool(const WorkerPool&) = delete;
+		WorkerPool& operator=(const WorkerPool&) = delete;
+
+		unsigned int size() const { return static_cast<unsigned int>(workers.size()); }
+
+		/* Run body(task, worker) for every task in [0, tasks); tasks are handed out in increasing
+		   order and the call returns once all of them are done */
+		void Run(std::size_t tasks, const std::function<void(std::size_t, unsigned int)>& body);
+
+	private:
+		void Work(unsigned int worker);
+
+		std::vector<std::thread> workers;
+		std::mutex mutex;
+		std::condition_variable wake;
+		std::condition_variable done;
+		const std::function<void(std::size_t, unsigned int)>* pBody = nullptr;
+		std::size_t taskCount = 0;
+		std::atomic<std::size_t> nextTask{0};
+		std::uint64_t generation = 0;
+		unsigned int busy = 0;
+		bool stopping = false;
+	};
+
+	/* Annotate the input chunk by chunk in parallel; write(pText, len) receives the output in
+	   input order, one call at a time, from whichever worker completes the next chunk. At most a
+	   few chunks per worker are buffered, so memory stays bounded however large the input is */
+	void AnnotateParallel(WorkerPool& pool, const char* pData, std::size_t size, std::size_t chunkSize, const ScanOptions& options,
+		const Annotations& annotations, const std::function<void(const char*, std::size_t)>& write);
+
+	/* Add the occurrences of every code in the input to counts, indexed by slot */
+	void CountParallel(WorkerPool& pool, const char* pData, std::size_t size, std::size_t chunkSize, const ScanOptions& options,
+		SlotCounts& counts);
+}
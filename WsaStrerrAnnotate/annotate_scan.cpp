@@ -0,0 +1,262 @@
+﻿// annotate_scan.cpp: digit-run search, code matching and per-chunk output.
+#include "annotate_scan.h"
+
+#include <cstring>
+
+#include "wsa_error.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ANNOTATE_SSE2 1
+#include <emmintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+namespace annotate
+{
+	namespace
+	{
+		/* Longest code has 5 digits; longer runs are ids, sizes or timestamps */
+		constexpr std::size_t maxDigits = 5;
+
+		constexpr std::size_t DigitCount(unsigned long code)
+		{
+			std::size_t count = 1;
+			for (; code >= 10; code /= 10)
+			{
+				++count;
+			}
+			return count;
+		}
+
+		constexpr bool CodeLengthsMatchFilter()
+		{
+			for (const auto& entry : wsa_strerr::errorEntries)
+			{
+				std::size_t count = DigitCount(entry.code);
+				if (count != 3 && count != maxDigits && count > 2)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		/* the SIMD filter in ForEachCode only passes runs of 3 or 5 digits, and 1 or 2 for smallCodes */
+		static_assert(CodeLengthsMatchFilter(), "codes must have 1, 2, 3 or 5 digits");
+
+		bool IsDigit(char c)
+		{
+			return static_cast<unsigned char>(c - '0') < 10;
+		}
+
+		bool IsWordChar(char c)
+		{
+			return IsDigit(c) || static_cast<unsigned char>((c | 0x20) - 'a') < 26 || c == '_';
+		}
+
+#ifdef ANNOTATE_SSE2
+		unsigned int CountTrailingZeros(unsigned int mask)
+		{
+#if defined(_MSC_VER) && !defined(__clang__)
+			unsigned long index;
+			_BitScanForward(&index, mask);
+			return index;
+#else
+			return static_cast<unsigned int>(__builtin_ctz(mask));
+#endif
+		}
+#endif
+
+		/* Slot of the digit run starting at `start` if it is a standalone known code, 0 otherwise.
+		   A code must not touch letters, digits or '_' (hex, ids), nor be part of a dotted number
+		   (addresses, versions, fractions); `end` receives the end of the run */
+		std::size_t MatchAt(const char* pData, Chunk chunk, std::size_t start, const ScanOptions& options, std::size_t& end)
+		{
+			unsigned long code = 0;
+			end = start;
+			while (end < chunk.end && end - start <= maxDigits && IsDigit(pData[end]))
+			{
+				code = code * 10 + static_cast<unsigned long>(pData[end] - '0');
+				++end;
+			}
+			std::size_t length = end - start;
+			if (length > maxDigits || (length < 3 && !options.smallCodes) || (pData[start] == '0' && length > 1))
+			{
+				return 0;
+			}
+			if (start > chunk.begin)
+			{
+				char before = pData[start - 1];
+				if (IsWordChar(before) || (before == '.' && start - 1 > chunk.begin && IsDigit(pData[start - 2])))
+				{
+					return 0;
+				}
+			}
+			if (end < chunk.end)
+			{
+				char after = pData[end];
+				if (IsWordChar(after) || (after == '.' && end + 1 < chunk.end && IsDigit(pData[end + 1])))
+				{
+					return 0;
+				}
+			}
+			std::size_t slot = wsa_strerr::SlotOf(code);
+			return wsa_strerr::errNameTable[slot] != nullptr ? slot : 0;
+		}
+
+		/* Call onMatch(start, end, slot) for every code in the chunk, in order */
+		template <typename OnMatch>
+		void ForEachCode(const char* pData, Chunk chunk, const ScanOptions& options, OnMatch onMatch)
+		{
+			std::size_t pos = chunk.begin;
+			std::size_t end;
+#ifdef ANNOTATE_SSE2
+			if (options.simd && chunk.end - chunk.begin >= 32)
+			{
+				const __m128i zero = _mm_set1_epi8('0');
+				const __m128i nine = _mm_set1_epi8(9);
+				/* digit bitmap of 16 bytes: bytes below '0' wrap around, so the digits are exactly the
+				   offsets with min(offset, 9) == offset */
+				auto digitMask = [&](std::size_t at) {
+					__m128i offsets = _mm_sub_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pData + at)), zero);
+					return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(offsets, nine), offsets)));
+				};
+				/* run lengths are read off the bitmap of this block and the next one, so only runs of
+				   a plausible length are parsed: timestamps and most ids never leave the registers */
+				std::uint32_t current = digitMask(pos);
+				std::uint32_t previous = 0; /* 1 when the byte before the block is a digit */
+				for (; pos + 32 <= chunk.end; pos += 16)
+				{
+					std::uint32_t next = digitMask(pos + 16);
+					std::uint32_t digits = current | next << 16;
+					std::uint32_t starts = current & ~((current << 1) | previous);
+					/* bit i of runN is set when at least N digits start at i; apart from the small
+					   codes every code has exactly 3 or 5 digits, which also drops years and ports */
+					std::uint32_t run3 = digits & (digits >> 1) & (digits >> 2);
+					std::uint32_t run4 = run3 & (digits >> 3);
+					std::uint32_t run5 = run4 & (digits >> 4);
+					std::uint32_t run6 = run5 & (digits >> 5);
+					std::uint32_t lengths = (run3 & ~run4) | (run5 & ~run6) | (options.smallCodes ? ~run3 : 0);
+					std::uint32_t candidates = starts & lengths;
+					previous = current >> 15;
+					current = next;
+					while (candidates != 0)
+					{
+						std::size_t start = pos + CountTrailingZeros(candidates);
+						candidates &= candidates - 1;
+						std::size_t slot = MatchAt(pData, chunk, start, options, end);
+						if (slot != 0)
+						{
+							onMatch(start, end, slot);
+						}
+					}
+				}
+			}
+#endif
+			/* the tail of the chunk, or all of it without SSE2 */
+			for (; pos < chunk.end; ++pos)
+			{
+				if (IsDigit(pData[pos]) && (pos == chunk.begin || !IsDigit(pData[pos - 1])))
+				{
+					std::size_t slot = MatchAt(pData, chunk, pos, options, end);
+					if (slot != 0)
+					{
+						onMatch(pos, end, slot);
+					}
+				}
+			}
+		}
+	}
+
+	std::vector<Chunk> SplitLines(const char* pData, std::size_t size, std::size_t chunkSize)
+	{
+		std::vector<Chunk> chunks;
+		chunkSize = chunkSize != 0 ? chunkSize : 1;
+		for (std::size_t begin = 0; begin < size;)
+		{
+			std::size_t end = size - begin > chunkSize ? begin + chunkSize : size;
+			if (end < size)
+			{
+				const void* pNewline = std::memchr(pData + end - 1, '\n', size - (end - 1));
+				end = pNewline != nullptr ? static_cast<std::size_t>(static_cast<const char*>(pNewline) - pData) + 1 : size;
+			}
+			chunks.push_back({begin, end});
+			begin = end;
+		}
+		return chunks;
+	}
+
+	Annotations::Annotations()
+	{
+		for (std::size_t slot = 1; slot < text.size(); ++slot)
+		{
+			unsigned long code = wsa_strerr::CodeOfSlot(slot);
+			const char* pszName = WSAErrorName(code);
+			if (pszName != nullptr)
+			{
+				text[slot].append(" [").append(pszName).append(": ").append(WSAStrError(code)).append("]");
+			}
+		}
+	}
+
+	void CountChunk(const char* pData, Chunk chunk, const ScanOptions& options, SlotCounts& counts)
+	{
+		ForEachCode(pData, chunk, options, [&](std::size_t, std::size_t, std::size_t slot) {
+			++counts[slot];
+		});
+	}
+
+	void AnnotateChunk(const char* pData, Chunk chunk, const ScanOptions& options, const Annotations& annotations, std::string& out)
+	{
+		std::size_t cursor = chunk.begin;      /* input before this has been copied or skipped */
+		std::size_t lineEnd = chunk.begin;     /* end of the line holding the last code, after its '\n' */
+		bool lineOpen = false;                 /* that line still has to be copied up to lineEnd */
+		auto finishLine = [&]() {
+			if (lineOpen)
+			{
+				out.append(pData + cursor, lineEnd - cursor);
+				if (pData[lineEnd - 1] != '\n')
+				{
+					out.push_back('\n');
+				}
+				cursor = lineEnd;
+				lineOpen = false;
+			}
+		};
+
+		ForEachCode(pData, chunk, options, [&](std::size_t start, std::size_t end, std::size_t slot) {
+			if (start >= lineEnd)
+			{
+				finishLine();
+				std::size_t lineStart = start;
+				while (lineStart > lineEnd && pData[lineStart - 1] != '\n')
+				{
+					--lineStart;
+				}
+				if (options.allLines)
+				{
+					out.append(pData + cursor, lineStart - cursor);
+				}
+				cursor = lineStart;
+				const void* pNewline = std::memchr(pData + end, '\n', chunk.end - end);
+				lineEnd = pNewline != nullptr ? static_cast<std::size_t>(static_cast<const char*>(pNewline) - pData) + 1 : chunk.end;
+				lineOpen = true;
+			}
+			out.append(pData + cursor, end - cursor);
+			out.append(annotations[slot]);
+			cursor = end;
+		});
+		finishLine();
+
+		if (options.allLines && cursor < chunk.end)
+		{
+			out.append(pData + cursor, chunk.end - cursor);
+			if (pData[chunk.end - 1] != '\n')
+			{
+				out.push_back('\n');
+			}
+		}
+	}
+}
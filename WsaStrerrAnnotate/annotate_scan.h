@@ -0,0 +1,52 @@
+﻿// annotate_scan.h: finds WSA error numbers in log text, then annotates or counts them.
+// A chunk is scanned 16 bytes at a time for the start of each digit run; only those few
+// positions are parsed and looked up, with the same slot table WSAStrError uses.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "wsa_error_table.h"
+
+namespace annotate
+{
+	struct ScanOptions
+	{
+		bool smallCodes = false;   /* also match 6, 8 and 87, which collide with ordinary numbers */
+		bool allLines = false;     /* copy lines without a code through unchanged */
+		bool simd = true;          /* false forces the byte-at-a-time digit search, for comparison */
+	};
+
+	/* Byte range [begin, end) of the input, starting at a line start and ending after a '\n' or at the end of the input */
+	struct Chunk
+	{
+		std::size_t begin;
+		std::size_t end;
+	};
+
+	/* Cut the input into chunks of about chunkSize bytes without splitting a line */
+	std::vector<Chunk> SplitLines(const char* pData, std::size_t size, std::size_t chunkSize);
+
+	/* " [WSAECONNRESET: Connection reset by peer]" for every slot, built once from WSAErrorName and WSAStrError */
+	class Annotations
+	{
+	public:
+		Annotations();
+		const std::string& operator[](std::size_t slot) const { return text[slot]; }
+
+	private:
+		std::array<std::string, wsa_strerr::slotCount> text;
+	};
+
+	using SlotCounts = std::array<std::uint64_t, wsa_strerr::slotCount>;
+
+	/* Add the number of times each code appears in the chunk to counts, indexed by slot */
+	void CountChunk(const char* pData, Chunk chunk, const ScanOptions& options, SlotCounts& counts);
+
+	/* Append the lines of the chunk that contain a code (every line with allLines) to out, with the
+	   annotation inserted after each code and a '\n' after the last line even when the input has none */
+	void AnnotateChunk(const char* pData, Chunk chunk, const ScanOptions& options, const Annotations& annotations, std::string& out);
+}
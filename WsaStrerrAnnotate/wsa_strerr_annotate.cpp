@@ -0,0 +1,166 @@
+﻿// wsa_strerr_annotate.cpp: annotates WSA error numbers in log files, or counts them.
+// Usage: wsa_strerr_annotate [--threads N] [--histogram] [--all-lines] [--small-codes] [--chunk-mb N] [--stats] file ...
+//   default       print the lines that contain a code, e.g. "recv: 10054 [WSAECONNRESET: Connection reset by peer]"
+//   --histogram   print how often each code appears over all files instead
+//   --all-lines   also print the lines without a code, unchanged
+//   --small-codes also match 6, 8 and 87, which are left out by default because plain numbers collide with them
+//   --stats       print the amount scanned and the throughput to stderr
+// Files are memory-mapped, so run it on rotated logs rather than live ones: lines appended after the
+// mapping are not seen, and on Linux a file truncated while mapped (logrotate's copytruncate) kills
+// the process with SIGBUS when the scan reaches the vanished pages. Windows refuses to truncate a
+// mapped file instead.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#include "annotate_map.h"
+#include "annotate_pool.h"
+#include "annotate_scan.h"
+#include "wsa_error.h"
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+namespace
+{
+	void Usage(const char* program)
+	{
+		std::fprintf(stderr,
+			"usage: %s [--threads N] [--histogram] [--all-lines] [--small-codes] [--chunk-mb N] [--stats] file ...\n", program);
+	}
+
+	void PrintHistogram(const annotate::SlotCounts& counts)
+	{
+		std::vector<std::size_t> slots;
+		for (std::size_t slot = 1; slot < counts.size(); ++slot)
+		{
+			if (counts[slot] != 0)
+			{
+				slots.push_back(slot);
+			}
+		}
+		std::stable_sort(slots.begin(), slots.end(), [&](std::size_t a, std::size_t b) { return counts[a] > counts[b]; });
+		std::printf("%12s %6s  %-26s %s\n", "count", "code", "name", "message");
+		for (std::size_t slot : slots)
+		{
+			unsigned long code = wsa_strerr::CodeOfSlot(slot);
+			std::printf("%12llu %6lu  %-26s %s\n", static_cast<unsigned long long>(counts[slot]), code, WSAErrorName(code),
+				WSAStrError(code));
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int hardwareThreads = std::thread::hardware_concurrency();
+	unsigned int threads = hardwareThreads ? hardwareThreads : 1;
+	std::size_t chunkSize = std::size_t{4} << 20;
+	bool histogram = false;
+	bool stats = false;
+	annotate::ScanOptions options;
+	std::vector<const char*> paths;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+		{
+			threads = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+			threads = threads != 0 ? threads : 1;
+		}
+		else if (std::strcmp(argv[i], "--chunk-mb") == 0 && i + 1 < argc)
+		{
+			chunkSize = static_cast<std::size_t>(std::strtoul(argv[++i], nullptr, 10)) << 20;
+			chunkSize = chunkSize != 0 ? chunkSize : std::size_t{1} << 20;
+		}
+		else if (std::strcmp(argv[i], "--histogram") == 0)
+		{
+			histogram = true;
+		}
+		else if (std::strcmp(argv[i], "--all-lines") == 0)
+		{
+			options.allLines = true;
+		}
+		else if (std::strcmp(argv[i], "--small-codes") == 0)
+		{
+			options.smallCodes = true;
+		}
+		else if (std::strcmp(argv[i], "--stats") == 0)
+		{
+			stats = true;
+		}
+		else if (argv[i][0] == '-' && argv[i][1] != '\0')
+		{
+			Usage(argv[0]);
+			return 1;
+		}
+		else
+		{
+			paths.push_back(argv[i]);
+		}
+	}
+	if (paths.empty())
+	{
+		Usage(argv[0]);
+		return 1;
+	}
+
+#if defined(_WIN32)
+	/* the input's line endings are copied as they are */
+	_setmode(_fileno(stdout), _O_BINARY);
+#endif
+	static char outputBuffer[1 << 20];
+	std::setvbuf(stdout, outputBuffer, _IOFBF, sizeof(outputBuffer));
+
+	annotate::WorkerPool pool(threads);
+	annotate::Annotations annotations;
+	annotate::SlotCounts counts{};
+	unsigned long long totalBytes = 0;
+	int status = 0;
+	auto startTime = std::chrono::steady_clock::now();
+
+	for (const char* pszPath : paths)
+	{
+		/* a truncation while mapped raises SIGBUS on Linux, see the note at the top */
+		annotate::MappedFile file;
+		int error = file.Open(pszPath);
+		if (error != 0)
+		{
+			std::fprintf(stderr, "%s: cannot map %s (error %d)\n", argv[0], pszPath, error);
+			status = 2;
+			continue;
+		}
+		totalBytes += file.size();
+		if (histogram)
+		{
+			annotate::CountParallel(pool, file.data(), file.size(), chunkSize, options, counts);
+		}
+		else
+		{
+			if (paths.size() > 1)
+			{
+				std::printf("==> %s <==\n", pszPath);
+			}
+			annotate::AnnotateParallel(pool, file.data(), file.size(), chunkSize, options, annotations,
+				[](const char* pText, std::size_t ulLen) { std::fwrite(pText, 1, ulLen, stdout); });
+		}
+	}
+
+	if (histogram)
+	{
+		PrintHistogram(counts);
+	}
+	std::fflush(stdout);
+
+	if (stats)
+	{
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+		std::fprintf(stderr, "scanned %llu bytes in %.3f s on %u threads, %.2f GB/s\n", totalBytes, seconds, pool.size(),
+			seconds > 0 ? static_cast<double>(totalBytes) / seconds / 1e9 : 0.0);
+	}
+	return status;
+}
@@ -0,0 +1,175 @@
+﻿// bench_annotate.cpp: throughput of the log annotator's scanner in GB/s on a synthetic log.
+#include "bench_suites.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
+#include "annotate_pool.h"
+#include "annotate_scan.h"
+#include "wsa_error.h"
+#include "wsa_error_table.h"
+
+namespace bench
+{
+	namespace
+	{
+		constexpr std::size_t logSize = std::size_t{256} << 20;
+		constexpr std::size_t chunkSize = std::size_t{4} << 20;
+
+		/* Service-log lines; one in eight reports a code, the others carry numbers that must not match:
+		   timestamps, addresses, hex, ids (kept below 995, the smallest three-digit code), durations */
+		std::string MakeLog(annotate::SlotCounts& expected)
+		{
+			static const char* const noise[] = {
+				"2026-10-17 08:15:42.123 [worker-%u] GET /api/v1/items/%u served in 87 ms, 100540 bytes\n",
+				"2026-10-17 08:15:42.124 [worker-%u] accepted peer 10.0.%u.1 id=0x10054 v1.10054\n",
+				"2026-10-17 08:15:42.125 [worker-%u] session 1000000%u closed, idle timer 600 s\n",
+			};
+			CodeMix mix = MakeSkewedMix(16);
+			std::string log;
+			log.reserve(logSize + 256);
+			std::mt19937 random(17);
+			char line[256];
+			for (std::size_t i = 0; log.size() < logSize; ++i)
+			{
+				unsigned int worker = random() % 64;
+				unsigned long code = mix[i & (mixSize - 1)];
+				std::size_t slot = wsa_strerr::SlotOf(code);
+				if (i % 8 == 0 && code >= 995 && slot != 0)
+				{
+					std::snprintf(line, sizeof(line), "2026-10-17 08:15:42.126 [worker-%u] WSARecv failed, error %lu\n", worker, code);
+					++expected[slot];
+				}
+				else
+				{
+					std::snprintf(line, sizeof(line), noise[i % 3], worker, static_cast<unsigned int>(random() % 900));
+				}
+				log += line;
+			}
+			return log;
+		}
+
+		void VerifyAnnotate(annotate::WorkerPool& pool, const std::string& log, const annotate::SlotCounts& expected,
+			const annotate::Annotations& annotations)
+		{
+			for (bool simd : {true, false})
+			{
+				annotate::ScanOptions options;
+				options.simd = simd;
+				annotate::SlotCounts counts{};
+				annotate::CountParallel(pool, log.data(), log.size(), chunkSize, options, counts);
+				if (counts != expected)
+				{
+					Fail("annotate mismatch: %s", simd ? "simd histogram" : "scalar histogram");
+				}
+			}
+
+			/* the parallel, ordered output must be the single-chunk output, and each annotation must
+			   be the library's text */
+			std::string serial;
+			annotate::AnnotateChunk(log.data(), {0, log.size()}, annotate::ScanOptions{}, annotations, serial);
+			std::string parallel;
+			annotate::AnnotateParallel(pool, log.data(), log.size(), std::size_t{1} << 16, annotate::ScanOptions{}, annotations,
+				[&](const char* pText, std::size_t ulLen) { parallel.append(pText, ulLen); });
+			std::string line = std::string("10054 [") + WSAErrorName(WSAECONNRESET) + ": " + WSAStrError(WSAECONNRESET) + "]";
+			if (serial != parallel || serial.find(line) == std::string::npos)
+			{
+				Fail("annotate mismatch: annotated output");
+			}
+
+			/* the same for the other modes, on a prefix to keep the run short: serial and scalar against
+			   parallel and SIMD, with small codes (the noise lines carry "87 ms") and with every line kept */
+			std::size_t prefix = log.find('\n', std::size_t{32} << 20) + 1;
+			std::size_t prefixLines = static_cast<std::size_t>(std::count(log.begin(), log.begin() + prefix, '\n'));
+			for (bool smallCodes : {false, true})
+			{
+				for (bool allLines : {false, true})
+				{
+					annotate::ScanOptions scalar;
+					scalar.smallCodes = smallCodes;
+					scalar.allLines = allLines;
+					scalar.simd = false;
+					annotate::ScanOptions simd = scalar;
+					simd.simd = true;
+
+					annotate::SlotCounts serialCounts{};
+					annotate::CountChunk(log.data(), {0, prefix}, scalar, serialCounts);
+					annotate::SlotCounts parallelCounts{};
+					annotate::CountParallel(pool, log.data(), prefix, std::size_t{1} << 16, simd, parallelCounts);
+					if (serialCounts != parallelCounts || (smallCodes && serialCounts[wsa_strerr::SlotOf(87)] == 0))
+					{
+						Fail("annotate mismatch: histogram with smallCodes=%d allLines=%d", smallCodes, allLines);
+					}
+
+					serial.clear();
+					annotate::AnnotateChunk(log.data(), {0, prefix}, scalar, annotations, serial);
+					parallel.clear();
+					annotate::AnnotateParallel(pool, log.data(), prefix, std::size_t{1} << 16, simd, annotations,
+						[&](const char* pText, std::size_t ulLen) { parallel.append(pText, ulLen); });
+					std::size_t lines = static_cast<std::size_t>(std::count(serial.begin(), serial.end(), '\n'));
+					if (serial != parallel || (allLines ? lines != prefixLines : lines >= prefixLines))
+					{
+						Fail("annotate mismatch: annotated output with smallCodes=%d allLines=%d", smallCodes, allLines);
+					}
+				}
+			}
+		}
+
+		void PrintThroughput(const char* name, unsigned int threads, std::size_t bytes, std::uint64_t ns)
+		{
+			std::printf("%-28s %-10s %7u %10.2f\n", name, "log", threads, static_cast<double>(bytes) / static_cast<double>(ns));
+		}
+
+		/* Best of a few runs, the first one also faults in the pages */
+		template <typename Scan>
+		std::uint64_t TimeScan(Scan scan)
+		{
+			std::uint64_t best = ~std::uint64_t{0};
+			for (int run = 0; run < 3; ++run)
+			{
+				std::uint64_t start = NowNs();
+				scan();
+				std::uint64_t elapsed = NowNs() - start;
+				best = elapsed < best ? elapsed : best;
+			}
+			return best;
+		}
+	}
+
+	void RunAnnotateSuite(const BenchOptions& options)
+	{
+		annotate::SlotCounts expected{};
+		std::string log = MakeLog(expected);
+		annotate::Annotations annotations;
+		{
+			annotate::WorkerPool pool(options.threads);
+			VerifyAnnotate(pool, log, expected, annotations);
+		}
+
+		std::printf("\n== log annotator (%zu MiB) ==\n", log.size() >> 20);
+		std::printf("%-28s %-10s %7s %10s\n", "case", "input", "threads", "GB/s");
+		ForEachThreadCount(options, [&](unsigned int threads) {
+			annotate::WorkerPool pool(threads);
+			annotate::ScanOptions simd;
+			annotate::ScanOptions scalar;
+			scalar.simd = false;
+			PrintThroughput("histogram", threads, log.size(), TimeScan([&] {
+				annotate::SlotCounts counts{};
+				annotate::CountParallel(pool, log.data(), log.size(), chunkSize, simd, counts);
+				DoNotOptimize(counts);
+			}));
+			PrintThroughput("histogram, scalar scan", threads, log.size(), TimeScan([&] {
+				annotate::SlotCounts counts{};
+				annotate::CountParallel(pool, log.data(), log.size(), chunkSize, scalar, counts);
+				DoNotOptimize(counts);
+			}));
+			PrintThroughput("annotate matching lines", threads, log.size(), TimeScan([&] {
+				std::size_t written = 0;
+				annotate::AnnotateParallel(pool, log.data(), log.size(), chunkSize, simd, annotations,
+					[&](const char*, std::size_t ulLen) { written += ulLen; });
+				DoNotOptimize(written);
+			}));
+		});
+	}
+}
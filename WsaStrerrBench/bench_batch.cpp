@@ -0,0 +1,111 @@
+﻿// bench_batch.cpp: WSAStrErrorBatch against a WSAStrError loop.
+// Before timing anything the suite checks, code by code, that the batch results are identical to
+// WSAStrError over every code around the known ranges, random codes and codes with high bits set,
+// at every start alignment; any difference aborts the run with exit status 1.
+#include "bench_suites.h"
+
+#include <climits>
+#include <cstdio>
+
+#include "wsa_error.h"
+#include "wsa_error_table.h"
+
+namespace bench
+{
+	namespace
+	{
+		std::vector<unsigned long> MakeDifferentialCodes()
+		{
+			std::vector<unsigned long> codes;
+			for (unsigned long code = 0; code <= WSA_QOS_RESERVED_PETYPE + 100; ++code)
+			{
+				codes.push_back(code);
+			}
+			std::mt19937 rng(6);
+			for (int i = 0; i < 100000; ++i)
+			{
+				codes.push_back(static_cast<unsigned long>(rng()));
+			}
+			codes.push_back(ULONG_MAX);
+			codes.push_back(0x80000000ul + WSAECONNRESET);
+			if constexpr (sizeof(unsigned long) > 4)
+			{
+				/* a real code in the low half must not hide the high bits */
+				for (int i = 0; i < 1000; ++i)
+				{
+					codes.push_back((static_cast<unsigned long>(rng()) << 32) | WSAECONNRESET);
+				}
+			}
+			return codes;
+		}
+
+		void VerifyBatch()
+		{
+			auto codes = MakeDifferentialCodes();
+			std::vector<const char*> out(codes.size());
+			for (std::size_t start = 0; start < 16; ++start)
+			{
+				std::size_t n = codes.size() - start;
+				WSAStrErrorBatch(codes.data() + start, n, out.data());
+				for (std::size_t i = 0; i < n; ++i)
+				{
+					if (out[i] != WSAStrError(codes[start + i]))
+					{
+						Fail("WSAStrErrorBatch mismatch for code %lu: \"%s\" != \"%s\"", codes[start + i], out[i],
+							WSAStrError(codes[start + i]));
+					}
+				}
+			}
+			std::printf("differential check: %zu codes x 16 alignments identical to WSAStrError\n", codes.size());
+		}
+
+		constexpr std::size_t batchSize = 4096;
+
+		template <typename Translate>
+		RunResult RunTranslate(const BenchOptions& options, unsigned int threads, const CodeMix& mix, Translate translate)
+		{
+			return RunThreads(threads, [&](unsigned int index) {
+				std::vector<const char*> out(batchSize);
+				std::uintptr_t sum = 0;
+				std::uint64_t done = 0;
+				std::size_t offset = (index * 4099u) & (mixSize - batchSize);
+				while (done < options.opsPerThread)
+				{
+					translate(mix.data() + offset, batchSize, out.data());
+					sum += reinterpret_cast<std::uintptr_t>(out[done & (batchSize - 1)]);
+					offset = (offset + batchSize) & (mixSize - 1);
+					done += batchSize;
+				}
+				DoNotOptimize(sum);
+				return done;
+			});
+		}
+	}
+
+	void RunBatchSuite(const BenchOptions& options)
+	{
+		VerifyBatch();
+		PrintHeader("batch translation");
+		const struct
+		{
+			const char* name;
+			CodeMix codes;
+		} mixes[] = {{"hit", MakeHitMix(7)}, {"uniform", MakeUniformMix(8)}};
+		for (const auto& mix : mixes)
+		{
+			ForEachThreadCount(options, [&](unsigned int threads) {
+				PrintResult("WSAStrErrorBatch", mix.name, threads,
+					RunTranslate(options, threads, mix.codes, [](const unsigned long* pCodes, std::size_t n, const char** ppOut) {
+						WSAStrErrorBatch(pCodes, n, ppOut);
+					}));
+				PrintResult("WSAStrError loop", mix.name, threads,
+					RunTranslate(options, threads, mix.codes, [](const unsigned long* pCodes, std::size_t n, const char** ppOut) {
+						for (std::size_t i = 0; i < n; ++i)
+						{
+							ppOut[i] = WSAStrError(pCodes[i]);
+						}
+					}));
+			});
+		}
+	}
+}
@@ -0,0 +1,72 @@
+﻿// bench_category.cpp: std::error_code integration, the string_view accessor against the allocating message().
+#include "bench_suites.h"
+
+#include <cstring>
+#include <system_error>
+
+#include "wsa_error.h"
+#include "wsa_error_category.h"
+#include "wsa_error_errc.h"
+#include "wsa_error_table.h"
+
+namespace bench
+{
+	namespace
+	{
+		void VerifyCode(unsigned long code)
+		{
+			std::error_code ec = wsa_strerr::make_error_code(static_cast<wsa_strerr::wsa_errc>(code));
+			std::string_view view = wsa_strerr::wsa_message(ec.value());
+			if (view != WSAStrError(code) || ec.message() != view || view.data()[view.size()] != '\0')
+			{
+				Fail("category mismatch: message for %lu", code);
+			}
+			std::error_condition condition = ec.default_error_condition();
+			int errc = wsa_strerr::LookupErrc(code);
+			if (errc != 0 ? condition != static_cast<std::errc>(errc)
+				: condition.category() != wsa_strerr::wsa_category() || condition.value() != ec.value())
+			{
+				Fail("category mismatch: default_error_condition for %lu", code);
+			}
+		}
+
+		void VerifyCategory()
+		{
+			if (std::strcmp(wsa_strerr::wsa_category().name(), "wsa") != 0)
+			{
+				Fail("category mismatch: name");
+			}
+			for (const auto& entry : wsa_strerr::errorEntries)
+			{
+				VerifyCode(entry.code);
+			}
+			for (unsigned long code : {0ul, 1ul, 10000ul, 10113ul, 0xFFFFFFFFul})
+			{
+				VerifyCode(code);
+			}
+			std::error_code ec = wsa_strerr::make_error_code(static_cast<wsa_strerr::wsa_errc>(WSAECONNRESET));
+			if (ec != std::errc::connection_reset || ec == std::errc::connection_aborted)
+			{
+				Fail("category mismatch: errc comparison for %lu", static_cast<unsigned long>(WSAECONNRESET));
+			}
+		}
+	}
+
+	void RunCategorySuite(const BenchOptions& options)
+	{
+		VerifyCategory();
+		PrintHeader("std::error_code integration");
+		CodeMix mix = MakeSkewedMix(14);
+		ForEachThreadCount(options, [&](unsigned int threads) {
+			PrintResult("wsa_message", "skewed", threads, RunPerThreadMix(options, threads, mix, [](unsigned long code) {
+				return wsa_strerr::wsa_message(static_cast<int>(code)).size();
+			}));
+			PrintResult("error_code::message", "skewed", threads, RunPerThreadMix(options, threads, mix, [](unsigned long code) {
+				return std::error_code(static_cast<int>(code), wsa_strerr::wsa_category()).message().size();
+			}));
+			PrintResult("== errc::connection_reset", "skewed", threads, RunPerThreadMix(options, threads, mix, [](unsigned long code) {
+				return static_cast<std::size_t>(std::error_code(static_cast<int>(code), wsa_strerr::wsa_category()) == std::errc::connection_reset);
+			}));
+		});
+	}
+}
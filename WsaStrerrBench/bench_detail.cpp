@@ -0,0 +1,95 @@
+﻿// bench_detail.cpp: WSAStrErrorDetail, checked against the entry list and timed next to WSAStrError.
+// Every listed code must return its own description, every other code (including listed codes with
+// high bits set) the "Unknown error" fallback; any difference aborts the run with exit status 1.
+#include "bench_suites.h"
+
+#include <climits>
+#include <cstdio>
+#include <cstring>
+
+#include "wsa_codes.h"
+#include "wsa_error.h"
+
+namespace bench
+{
+	namespace
+	{
+		struct ListedEntry
+		{
+			unsigned long code;
+			const char* message;
+			const char* detail;
+		};
+
+		/* straight from the list, independent of the offset tables in wsa_error_detail.cpp */
+		const ListedEntry listedEntries[] = {
+#define WSA_ERROR_ENTRY(code, message, detail) {code, message, detail},
+#include "wsa_error_list.h"
+#undef WSA_ERROR_ENTRY
+		};
+
+		const ListedEntry* FindListed(unsigned long code)
+		{
+			for (const auto& entry : listedEntries)
+			{
+				if (entry.code == code)
+				{
+					return &entry;
+				}
+			}
+			return nullptr;
+		}
+
+		void ExpectDetail(unsigned long code, const char* expected)
+		{
+			const char* detail = WSAStrErrorDetail(code);
+			if (detail == nullptr || std::strcmp(detail, expected) != 0)
+			{
+				Fail("WSAStrErrorDetail mismatch for code %lu: \"%s\" != \"%s\"", code, detail != nullptr ? detail : "(null)",
+					expected);
+			}
+		}
+
+		void VerifyDetail()
+		{
+			std::size_t checked = 0;
+			for (unsigned long code = 0; code <= WSA_QOS_RESERVED_PETYPE + 100; ++code, ++checked)
+			{
+				const ListedEntry* entry = FindListed(code);
+				ExpectDetail(code, entry != nullptr ? entry->detail : "Unknown error");
+			}
+			for (const auto& entry : listedEntries)
+			{
+				/* every listed code is below 2^16, so any higher bit makes it unknown */
+				for (unsigned int bit = 16; bit < sizeof(unsigned long) * CHAR_BIT; ++bit, ++checked)
+				{
+					ExpectDetail(entry.code | (1ul << bit), "Unknown error");
+				}
+			}
+			ExpectDetail(ULONG_MAX, "Unknown error");
+
+			/* the two short messages that once disagreed with the Winsock documentation */
+			if (std::strcmp(WSAStrError(WSAEREMOTE), "Item is remote") != 0
+				|| std::strcmp(WSAStrError(WSATYPE_NOT_FOUND), "Class type not found") != 0)
+			{
+				Fail("WSAStrError mismatch for WSAEREMOTE or WSATYPE_NOT_FOUND");
+			}
+			ExpectDetail(WSAEREMOTE, "The item is not available locally.");
+			ExpectDetail(WSATYPE_NOT_FOUND, "The specified class was not found.");
+			std::printf("detail check: %zu codes match the entry list\n", checked + 1);
+		}
+	}
+
+	void RunDetailSuite(const BenchOptions& options)
+	{
+		VerifyDetail();
+		PrintHeader("WSAStrErrorDetail lookup");
+		CodeMix mix = MakeSkewedMix(16);
+		ForEachThreadCount(options, [&](unsigned int threads) {
+			PrintResult("WSAStrErrorDetail", "skewed", threads,
+				RunPerThreadMix(options, threads, mix, [](unsigned long code) { return WSAStrErrorDetail(code); }));
+			PrintResult("WSAStrError", "skewed", threads,
+				RunPerThreadMix(options, threads, mix, [](unsigned long code) { return WSAStrError(code); }));
+		});
+	}
+}
@@ -0,0 +1,133 @@
+﻿// bench_errno.cpp: WSA <-> errno translation tables against the switch statements callers write by hand.
+#include "bench_suites.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include "wsa_errno.h"
+#include "wsa_error.h"
+
+namespace bench
+{
+	namespace
+	{
+		/* both directions must fold to constants */
+		static_assert(wsa_strerr::wsa_to_errno(WSAECONNRESET) == ECONNRESET, "WSAECONNRESET maps to ECONNRESET");
+		static_assert(wsa_strerr::errno_to_wsa(ECONNRESET) == WSAECONNRESET, "ECONNRESET maps to WSAECONNRESET");
+		static_assert(wsa_strerr::errno_to_wsa(EINVAL) == WSAEINVAL, "EINVAL maps to the socket code");
+		static_assert(wsa_strerr::errno_to_wsa(-1) == 0, "negative values have no WSA code");
+#if !defined(_WIN32)
+		/* socket errors follow what Windows reports in the same situation, errno_to_wsa stays the table inverse */
+		static_assert(wsa_strerr::socket_error_to_wsa(EINPROGRESS) == WSAEWOULDBLOCK, "non-blocking connect() is WSAEWOULDBLOCK");
+		static_assert(wsa_strerr::socket_error_to_wsa(ECANCELED) == WSA_OPERATION_ABORTED, "cancelled I/O is WSA_OPERATION_ABORTED");
+		static_assert(wsa_strerr::errno_to_wsa(EINPROGRESS) == WSAEINPROGRESS, "EINPROGRESS inverts wsa_to_errno");
+		static_assert(wsa_strerr::errno_to_wsa(ECANCELED) == WSAECANCELLED, "ECANCELED inverts wsa_to_errno");
+#endif
+
+		void VerifyErrno()
+		{
+			for (const auto& entry : wsa_strerr::errorEntries)
+			{
+				int error = wsa_strerr::wsa_to_errno(entry.code);
+				if (error != 0 && wsa_strerr::wsa_to_errno(wsa_strerr::errno_to_wsa(error)) != error)
+				{
+					Fail("errno mismatch: wsa_to_errno round trip for %lu", entry.code);
+				}
+			}
+			for (int error = -8; error < 1024; ++error)
+			{
+				unsigned long code = wsa_strerr::errno_to_wsa(error);
+				if (code != 0 && wsa_strerr::wsa_to_errno(code) != error)
+				{
+					Fail("errno mismatch: errno_to_wsa round trip for %d", error);
+				}
+			}
+#if !defined(_WIN32)
+			if (std::strcmp(wsa_strerr::socket_strerror(ECONNRESET), WSAStrError(WSAECONNRESET)) != 0
+				|| std::strcmp(wsa_strerr::socket_strerror(EWOULDBLOCK), WSAStrError(WSAEWOULDBLOCK)) != 0)
+			{
+				Fail("errno mismatch: socket_strerror");
+			}
+			for (int error = -8; error < 1024; ++error)
+			{
+				unsigned long code = wsa_strerr::socket_error_to_wsa(error);
+				unsigned long expected = error == EINPROGRESS ? WSAEWOULDBLOCK : error == ECANCELED ? WSA_OPERATION_ABORTED
+					: wsa_strerr::errno_to_wsa(error);
+				if (code != expected || std::strcmp(wsa_strerr::socket_strerror(error), WSAStrError(code)) != 0)
+				{
+					Fail("errno mismatch: socket_error_to_wsa for %d", error);
+				}
+			}
+#endif
+		}
+
+		/* The hand-written translation this replaces, covering the errnos servers usually check */
+		unsigned long SwitchErrnoToWsa(int iErrno)
+		{
+			switch (iErrno)
+			{
+			case EINTR: return WSAEINTR;
+			case EBADF: return WSAEBADF;
+			case EACCES: return WSAEACCES;
+			case EFAULT: return WSAEFAULT;
+			case EINVAL: return WSAEINVAL;
+			case EMFILE: return WSAEMFILE;
+			case EWOULDBLOCK: return WSAEWOULDBLOCK;
+			case EINPROGRESS: return WSAEINPROGRESS;
+			case EALREADY: return WSAEALREADY;
+			case ENOTSOCK: return WSAENOTSOCK;
+			case EMSGSIZE: return WSAEMSGSIZE;
+			case EADDRINUSE: return WSAEADDRINUSE;
+			case EADDRNOTAVAIL: return WSAEADDRNOTAVAIL;
+			case ENETDOWN: return WSAENETDOWN;
+			case ENETUNREACH: return WSAENETUNREACH;
+			case ECONNABORTED: return WSAECONNABORTED;
+			case ECONNRESET: return WSAECONNRESET;
+			case ENOBUFS: return WSAENOBUFS;
+			case EISCONN: return WSAEISCONN;
+			case ENOTCONN: return WSAENOTCONN;
+			case ETIMEDOUT: return WSAETIMEDOUT;
+			case ECONNREFUSED: return WSAECONNREFUSED;
+			case EHOSTUNREACH: return WSAEHOSTUNREACH;
+			default: return 0;
+			}
+		}
+
+		using ErrnoMix = std::vector<int>;
+
+		ErrnoMix ToErrnoMix(const CodeMix& mix)
+		{
+			ErrnoMix errors;
+			errors.reserve(mix.size());
+			for (unsigned long code : mix)
+			{
+				errors.push_back(wsa_strerr::wsa_to_errno(code));
+			}
+			return errors;
+		}
+	}
+
+	void RunErrnoSuite(const BenchOptions& options)
+	{
+		VerifyErrno();
+		PrintHeader("WSA <-> errno translation");
+		ErrnoMix mix = ToErrnoMix(MakeSkewedMix(15));
+		ForEachThreadCount(options, [&](unsigned int threads) {
+			PrintResult("errno_to_wsa", "skewed", threads, RunPerThreadMix(options, threads, mix, [](int error) {
+				return wsa_strerr::errno_to_wsa(error);
+			}));
+			PrintResult("baseline switch", "skewed", threads, RunPerThreadMix(options, threads, mix, [](int error) {
+				return SwitchErrnoToWsa(error);
+			}));
+			PrintResult("socket_strerror", "skewed", threads, RunPerThreadMix(options, threads, mix, [](int error) {
+				return wsa_strerr::socket_strerror(error);
+			}));
+#if !defined(_WIN32)
+			/* glibc's strerror is thread-safe for valid errnos, but still goes through the locale */
+			PrintResult("baseline strerror", "skewed", threads, RunPerThreadMix(options, threads, mix, [](int error) {
+				return std::strerror(error);
+			}));
+#endif
+		});
+	}
+}
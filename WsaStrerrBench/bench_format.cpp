@@ -0,0 +1,122 @@
+﻿// bench_format.cpp: WSAStrError_r against the snprintf formatting callers used to do by hand.
+#include "bench_suites.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "wsa_error.h"
+#include "wsa_error_table.h"
+
+namespace bench
+{
+	namespace
+	{
+		/* The full text WSAStrError_r should produce, built independently of BufferWriter */
+		std::string ExpectedText(unsigned long code, unsigned int flags)
+		{
+			std::string text = WSAStrError(code);
+			const char* name = (flags & WSA_STRERR_WITH_NAME) ? WSAErrorName(code) : nullptr;
+			bool withCode = (flags & WSA_STRERR_WITH_CODE) != 0;
+			if (name != nullptr || withCode)
+			{
+				text += " (";
+				if (name != nullptr)
+				{
+					text += name;
+					text += withCode ? " " : "";
+				}
+				if (withCode)
+				{
+					text += std::to_string(code);
+				}
+				text += ')';
+			}
+			return text;
+		}
+
+		/* Every buffer size from 0 to two past the full text: the result is the truncated prefix, always
+		   NUL-terminated, the return value is its length, and nothing past ulBufLen is written */
+		void VerifyCode(unsigned long code, unsigned int flags)
+		{
+			std::string expected = ExpectedText(code, flags);
+			if (WSAStrError_r(code, nullptr, 0, flags) != 0)
+			{
+				Fail("format mismatch: null buffer for %lu flags %u", code, flags);
+			}
+			char buffer[192];
+			for (std::size_t size = 0; size <= expected.size() + 2; ++size)
+			{
+				std::memset(buffer, '#', sizeof(buffer));
+				std::size_t length = WSAStrError_r(code, buffer, size, flags);
+				std::size_t wanted = size == 0 ? 0 : std::min(expected.size(), size - 1);
+				if (length != wanted || std::memcmp(buffer, expected.data(), length) != 0)
+				{
+					Fail("format mismatch: text for %lu flags %u size %zu", code, flags, size);
+				}
+				if (size != 0 && buffer[length] != '\0')
+				{
+					Fail("format mismatch: missing NUL for %lu flags %u size %zu", code, flags, size);
+				}
+				for (std::size_t i = size; i < sizeof(buffer); ++i)
+				{
+					if (buffer[i] != '#')
+					{
+						Fail("format mismatch: write past the buffer for %lu flags %u size %zu", code, flags, size);
+					}
+				}
+			}
+		}
+
+		void VerifyFormat()
+		{
+			const unsigned int flagSets[] = {0u, WSA_STRERR_WITH_CODE, WSA_STRERR_WITH_NAME, WSA_STRERR_WITH_CODE | WSA_STRERR_WITH_NAME};
+			for (unsigned int flags : flagSets)
+			{
+				for (const auto& entry : wsa_strerr::errorEntries)
+				{
+					VerifyCode(entry.code, flags);
+				}
+				for (unsigned long code : {0ul, 1ul, 10000ul, 10113ul, 0xFFFFFFFFul})
+				{
+					VerifyCode(code, flags);
+				}
+			}
+		}
+
+		/* Like RunPerThreadMix, with a thread-local output buffer handed to format */
+		template <typename Format>
+		RunResult RunFormat(const BenchOptions& options, unsigned int threads, const CodeMix& mix, Format format)
+		{
+			return RunThreads(threads, [&](unsigned int index) {
+				char buffer[128];
+				std::size_t sum = 0;
+				std::size_t offset = index * 4099u;
+				for (std::uint64_t i = 0; i < options.opsPerThread; ++i)
+				{
+					sum += format(mix[(i + offset) & (mixSize - 1)], buffer, sizeof(buffer));
+				}
+				DoNotOptimize(sum);
+				return options.opsPerThread;
+			});
+		}
+	}
+
+	void RunFormatSuite(const BenchOptions& options)
+	{
+		VerifyFormat();
+		PrintHeader("message formatting");
+		CodeMix mix = MakeSkewedMix(5);
+		ForEachThreadCount(options, [&](unsigned int threads) {
+			PrintResult("WSAStrError_r", "skewed", threads,
+				RunFormat(options, threads, mix, [](unsigned long code, char* pBuf, std::size_t ulBufLen) {
+					return WSAStrError_r(code, pBuf, ulBufLen, WSA_STRERR_WITH_CODE);
+				}));
+			PrintResult("snprintf + WSAStrError", "skewed", threads,
+				RunFormat(options, threads, mix, [](unsigned long code, char* pBuf, std::size_t ulBufLen) {
+					return static_cast<std::size_t>(std::snprintf(pBuf, ulBufLen, "%s (%lu)", WSAStrError(code), code));
+				}));
+		});
+	}
+}
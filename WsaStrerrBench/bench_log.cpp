@@ -0,0 +1,170 @@
+﻿// bench_log.cpp: stress test and throughput of the asynchronous error log.
+// Producers hammer WSAErrorLogPush through a deliberately small ring while the writer thread
+// delivers lines to a counting callback. After WSAErrorLogStop every accepted push must have become
+// exactly one line and every rejected one must be in WSAErrorLogDropped; otherwise exit status 1.
+#include "bench_suites.h"
+
+#include <cstdio>
+
+#include "wsa_codes.h"
+#include "wsa_error.h"
+
+namespace bench
+{
+	namespace
+	{
+		struct LineCounter
+		{
+			std::atomic<std::uint64_t> lines{0};
+			std::atomic<std::uint64_t> bytes{0};
+		};
+
+		void CountLines(const char* pBatch, size_t ulLen, void* pContext)
+		{
+			auto* counter = static_cast<LineCounter*>(pContext);
+			std::uint64_t lines = 0;
+			for (size_t i = 0; i < ulLen; ++i)
+			{
+				lines += pBatch[i] == '\n';
+			}
+			counter->lines.fetch_add(lines, std::memory_order_relaxed);
+			counter->bytes.fetch_add(ulLen, std::memory_order_relaxed);
+		}
+
+		void RunRound(const BenchOptions& options, unsigned int threads, unsigned int capacity, unsigned int maxPerCode,
+			const CodeMix& mix, const char* name)
+		{
+			LineCounter counter;
+			WSAErrorLogConfig config{};
+			config.pfnCallback = CountLines;
+			config.pContext = &counter;
+			config.uCapacity = capacity;
+			config.uFlushIntervalMs = 50;
+			config.uMaxPerCode = maxPerCode;
+			if (WSAErrorLogStart(&config) != 0)
+			{
+				Fail("error log stress: WSAErrorLogStart failed");
+			}
+			if (WSAErrorLogStart(&config) == 0)
+			{
+				Fail("error log stress: second WSAErrorLogStart succeeded");
+			}
+
+			std::uint64_t opsPerThread = options.opsPerThread / 10;
+			std::atomic<std::uint64_t> accepted{0};
+			std::atomic<std::uint64_t> rejected{0};
+			RunResult result = RunThreads(threads, [&](unsigned int index) {
+				std::uint64_t ok = 0;
+				std::size_t offset = index * 4099u;
+				for (std::uint64_t i = 0; i < opsPerThread; ++i)
+				{
+					ok += WSAErrorLogPush(mix[(i + offset) & (mixSize - 1)], i, "bench") == 0;
+				}
+				accepted.fetch_add(ok);
+				rejected.fetch_add(opsPerThread - ok);
+				return opsPerThread;
+			});
+			WSAErrorLogStop();
+			PrintResult("WSAErrorLogPush", name, threads, result);
+
+			if (WSAErrorLogPush(WSAECONNRESET, 0, "late") == 0)
+			{
+				Fail("error log stress: push accepted after WSAErrorLogStop");
+			}
+			if (rejected.load() != WSAErrorLogDropped())
+			{
+				Fail("error log stress: rejected pushes and WSAErrorLogDropped disagree");
+			}
+			if (maxPerCode == 0 && counter.lines.load() != accepted.load())
+			{
+				std::printf("accepted %llu, delivered %llu\n", static_cast<unsigned long long>(accepted.load()),
+					static_cast<unsigned long long>(counter.lines.load()));
+				Fail("error log stress: lost or duplicated records");
+			}
+			std::printf("%-28s accepted %llu, dropped %llu, delivered %llu lines (%llu bytes)\n", "",
+				static_cast<unsigned long long>(accepted.load()), WSAErrorLogDropped(),
+				static_cast<unsigned long long>(counter.lines.load()), static_cast<unsigned long long>(counter.bytes.load()));
+		}
+
+		/* an idle writer sleeps without a timeout: only the push itself can get its line written */
+		void VerifyIdleWakeup()
+		{
+			LineCounter counter;
+			WSAErrorLogConfig config{};
+			config.pfnCallback = CountLines;
+			config.pContext = &counter;
+			config.uFlushIntervalMs = 10;
+			if (WSAErrorLogStart(&config) != 0)
+			{
+				Fail("error log stress: WSAErrorLogStart failed");
+			}
+			for (std::uint64_t expected = 1; expected <= 3; ++expected)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(50));
+				WSAErrorLogPush(WSAECONNREFUSED, expected, "idle");
+				auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+				while (counter.lines.load() < expected)
+				{
+					if (std::chrono::steady_clock::now() > deadline)
+					{
+						Fail("error log stress: a push did not wake the idle writer");
+					}
+					std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				}
+			}
+			WSAErrorLogStop();
+			std::printf("%-28s 3 pushes woke the idle writer\n", "");
+		}
+	}
+
+	void RunLogSuite(const BenchOptions& options)
+	{
+		/* before the first start there is no log state: stop and push must be harmless no-ops */
+		WSAErrorLogStop();
+		if (WSAErrorLogPush(WSAECONNRESET, 0, "early") == 0)
+		{
+			Fail("error log stress: push accepted before WSAErrorLogStart");
+		}
+		PrintHeader("asynchronous error log");
+		CodeMix mix = MakeSkewedMix(10);
+		unsigned int producers = options.threads < 2 ? 2 : options.threads;
+		/* a small ring so producers keep colliding with a full queue and the writer */
+		RunRound(options, producers, 1024, 0, mix, "small ring");
+		RunRound(options, producers, 1 << 16, 0, mix, "large ring");
+		RunRound(options, producers, 1 << 16, 8, mix, "rate limit");
+		VerifyIdleWakeup();
+
+		/* start/stop cycles racing with producers that never stop pushing */
+		std::atomic<bool> done{false};
+		std::thread pusher([&]() {
+			while (!done.load(std::memory_order_relaxed))
+			{
+				WSAErrorLogPush(WSAETIMEDOUT, 0, "cycle");
+			}
+		});
+		LineCounter counter;
+		WSAErrorLogConfig config{};
+		config.pfnCallback = CountLines;
+		config.pContext = &counter;
+		config.uFlushIntervalMs = 1;
+		config.uCapacity = 0xFFFFFFFFu;
+		if (WSAErrorLogStart(&config) == 0)
+		{
+			Fail("error log stress: WSAErrorLogStart accepted an oversized ring");
+		}
+		config.uCapacity = 0;
+		for (int i = 0; i < 200; ++i)
+		{
+			if (WSAErrorLogStart(&config) != 0)
+			{
+				Fail("error log stress: WSAErrorLogStart failed while cycling");
+			}
+			std::this_thread::yield();
+			WSAErrorLogStop();
+		}
+		done.store(true);
+		pusher.join();
+		std::printf("%-28s 200 start/stop cycles with a concurrent producer, %llu lines\n", "",
+			static_cast<unsigned long long>(counter.lines.load()));
+	}
+}
@@ -0,0 +1,143 @@
+﻿// bench_lookup.cpp: WSAStrError lookup throughput and table initialization cost.
+// The pre-constexpr std::unordered_map<unsigned long, std::string> table is rebuilt here from
+// the same entry list and measured side by side, as the baseline for any future table layout.
+#include "bench_suites.h"
+
+#include <cstdio>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "wsa_error.h"
+#include "wsa_error_table.h"
+
+namespace bench
+{
+	namespace
+	{
+		std::atomic<std::size_t> allocatedBytes{0};
+		std::atomic<std::size_t> allocationCount{0};
+
+		/* std::allocator that keeps a tally, so the baseline's heap footprint can be reported */
+		template <typename T>
+		struct CountingAllocator
+		{
+			using value_type = T;
+
+			CountingAllocator() = default;
+			template <typename U>
+			CountingAllocator(const CountingAllocator<U>&) noexcept {}
+
+			T* allocate(std::size_t n)
+			{
+				allocatedBytes.fetch_add(n * sizeof(T), std::memory_order_relaxed);
+				allocationCount.fetch_add(1, std::memory_order_relaxed);
+				return std::allocator<T>().allocate(n);
+			}
+
+			void deallocate(T* p, std::size_t n) noexcept
+			{
+				std::allocator<T>().deallocate(p, n);
+			}
+
+			template <typename U>
+			bool operator==(const CountingAllocator<U>&) const noexcept { return true; }
+			template <typename U>
+			bool operator!=(const CountingAllocator<U>&) const noexcept { return false; }
+		};
+
+		using LegacyString = std::basic_string<char, std::char_traits<char>, CountingAllocator<char>>;
+		using LegacyMap = std::unordered_map<unsigned long, LegacyString, std::hash<unsigned long>,
+			std::equal_to<unsigned long>, CountingAllocator<std::pair<const unsigned long, LegacyString>>>;
+
+		LegacyMap BuildLegacyMap()
+		{
+			LegacyMap map;
+			for (const auto& entry : wsa_strerr::errorEntries)
+			{
+				map.emplace(entry.code, LegacyString(entry.message));
+			}
+			return map;
+		}
+
+		/* The lookup as it was before the constexpr table */
+		const char* LegacyStrError(const LegacyMap& map, unsigned long ulErrno)
+		{
+			auto value = map.find(ulErrno);
+			if (value != map.end())
+			{
+				return value->second.c_str();
+			}
+			else
+			{
+				return "Unknown error";
+			}
+		}
+
+		struct NamedMix
+		{
+			const char* name;
+			CodeMix codes;
+		};
+
+		std::vector<NamedMix> MakeMixes()
+		{
+			std::vector<NamedMix> mixes;
+			mixes.push_back({"hit", MakeHitMix(1)});
+			mixes.push_back({"miss", MakeMissMix(2)});
+			mixes.push_back({"skewed", MakeSkewedMix(3)});
+			mixes.push_back({"uniform", MakeUniformMix(4)});
+			return mixes;
+		}
+	}
+
+	void RunLookupSuite(const BenchOptions& options)
+	{
+		PrintHeader("WSAStrError lookup");
+		auto mixes = MakeMixes();
+		LegacyMap legacy = BuildLegacyMap();
+		for (const auto& mix : mixes)
+		{
+			ForEachThreadCount(options, [&](unsigned int threads) {
+				PrintResult("WSAStrError", mix.name, threads,
+					RunPerThreadMix(options, threads, mix.codes, [](unsigned long code) { return WSAStrError(code); }));
+				PrintResult("baseline unordered_map", mix.name, threads,
+					RunPerThreadMix(options, threads, mix.codes, [&](unsigned long code) { return LegacyStrError(legacy, code); }));
+			});
+		}
+	}
+
+	void RunInitSuite(const BenchOptions&)
+	{
+		std::printf("\n== table initialization and memory ==\n");
+
+		constexpr int rounds = 200;
+		std::uint64_t elapsed = 0;
+		std::size_t bytes = 0;
+		std::size_t allocations = 0;
+		for (int i = 0; i < rounds; ++i)
+		{
+			allocatedBytes.store(0);
+			allocationCount.store(0);
+			std::uint64_t begin = NowNs();
+			LegacyMap map = BuildLegacyMap();
+			elapsed += NowNs() - begin;
+			DoNotOptimize(map);
+			bytes = allocatedBytes.load();
+			allocations = allocationCount.load();
+		}
+		std::printf("%-28s init %8.2f us, heap %6zu bytes in %4zu allocations\n", "baseline unordered_map",
+			static_cast<double>(elapsed) / rounds / 1e3, bytes, allocations);
+
+		/* the constexpr table is rodata with no initializer, so there is no load-time cost to time;
+		   a LoadLibrary loop cannot show one either, the bench already holds the DLL loaded */
+		std::size_t stringBytes = 0;
+		for (const auto& entry : wsa_strerr::errorEntries)
+		{
+			stringBytes += std::char_traits<char>::length(entry.message) + 1;
+		}
+		std::printf("%-28s init %8.2f us, rodata %4zu bytes of table + %zu bytes of strings (%zu slots)\n", "constexpr table",
+			0.0, sizeof(wsa_strerr::errStrTable) + sizeof(wsa_strerr::codeRanges), stringBytes, wsa_strerr::slotCount);
+	}
+}
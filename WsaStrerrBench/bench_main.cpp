@@ -0,0 +1,93 @@
+﻿// bench_main.cpp: benchmark driver for the wsa_strerr library.
+// Usage: wsa_strerr_bench [--threads N] [--ops N] [suite ...]
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#include "bench_suites.h"
+
+namespace
+{
+	struct BenchSuite
+	{
+		const char* name;
+		void (*run)(const bench::BenchOptions&);
+	};
+
+	const BenchSuite suites[] = {
+		{"lookup", bench::RunLookupSuite},
+		{"init", bench::RunInitSuite},
+		{"format", bench::RunFormatSuite},
+		{"detail", bench::RunDetailSuite},
+		{"batch", bench::RunBatchSuite},
+		{"stats", bench::RunStatsSuite},
+		{"log", bench::RunLogSuite},
+		{"names", bench::RunNamesSuite},
+		{"category", bench::RunCategorySuite},
+		{"errno", bench::RunErrnoSuite},
+		{"annotate", bench::RunAnnotateSuite},
+	};
+
+	void Usage(const char* program)
+	{
+		std::printf("usage: %s [--threads N] [--ops N] [suite ...]\nsuites:", program);
+		for (const auto& suite : suites)
+		{
+			std::printf(" %s", suite.name);
+		}
+		std::printf("\n");
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	bench::BenchOptions options;
+	unsigned int hardwareThreads = std::thread::hardware_concurrency();
+	options.threads = hardwareThreads ? hardwareThreads : 1;
+
+	bool selected[sizeof(suites) / sizeof(suites[0])]{};
+	bool anySelected = false;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+		{
+			options.threads = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+			if (options.threads == 0)
+			{
+				options.threads = 1;
+			}
+		}
+		else if (std::strcmp(argv[i], "--ops") == 0 && i + 1 < argc)
+		{
+			options.opsPerThread = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else
+		{
+			bool found = false;
+			for (std::size_t s = 0; s < sizeof(suites) / sizeof(suites[0]); ++s)
+			{
+				if (std::strcmp(argv[i], suites[s].name) == 0)
+				{
+					selected[s] = true;
+					anySelected = found = true;
+				}
+			}
+			if (!found)
+			{
+				Usage(argv[0]);
+				return 1;
+			}
+		}
+	}
+
+	std::printf("threads=%u ops/thread=%llu\n", options.threads, static_cast<unsigned long long>(options.opsPerThread));
+	for (std::size_t s = 0; s < sizeof(suites) / sizeof(suites[0]); ++s)
+	{
+		if (!anySelected || selected[s])
+		{
+			suites[s].run(options);
+		}
+	}
+	return 0;
+}
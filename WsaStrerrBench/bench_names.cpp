@@ -0,0 +1,81 @@
+﻿// bench_names.cpp: name -> code lookup, the perfect hash against std::unordered_map<std::string, ...>.
+#include "bench_suites.h"
+
+#include <cstring>
+#include <string>
+#include <unordered_map>
+
+#include "wsa_error.h"
+#include "wsa_error_table.h"
+
+namespace bench
+{
+	namespace
+	{
+		/* Names to look up: known names drawn from a code mix, or names that look right but are not */
+		std::vector<std::string> MakeNames(const CodeMix& mix, bool misses)
+		{
+			std::vector<std::string> names;
+			names.reserve(mix.size());
+			for (unsigned long code : mix)
+			{
+				std::string name = WSAErrorName(code) != nullptr ? WSAErrorName(code) : "WSAEUNKNOWN";
+				if (misses)
+				{
+					name.back() = name.back() == 'X' ? 'Y' : 'X';
+				}
+				names.push_back(std::move(name));
+			}
+			return names;
+		}
+
+		void VerifyNames()
+		{
+			for (const auto& entry : wsa_strerr::errorEntries)
+			{
+				if (WSAErrorFromName(entry.name) != entry.code || std::strcmp(WSAErrorName(entry.code), entry.name) != 0)
+				{
+					Fail("name lookup mismatch for %s", entry.name);
+				}
+			}
+			/* shorter than any name, a prefix, a different case, one character appended */
+			for (const char* name : {"", "W", "WSAE", "WSAEINT", "wsaeconnreset", "WSAECONNRESETX", "WSAECONNRESET "})
+			{
+				if (WSAErrorFromName(name) != 0)
+				{
+					Fail("name lookup accepted \"%s\"", name);
+				}
+			}
+		}
+	}
+
+	void RunNamesSuite(const BenchOptions& options)
+	{
+		VerifyNames();
+		PrintHeader("name -> code lookup");
+		std::unordered_map<std::string, unsigned long> baseline;
+		for (const auto& entry : wsa_strerr::errorEntries)
+		{
+			baseline.emplace(entry.name, entry.code);
+		}
+
+		const struct
+		{
+			const char* name;
+			std::vector<std::string> names;
+		} mixes[] = {{"hit", MakeNames(MakeHitMix(11), false)}, {"skewed", MakeNames(MakeSkewedMix(12), false)},
+			{"miss", MakeNames(MakeHitMix(13), true)}};
+		for (const auto& mix : mixes)
+		{
+			ForEachThreadCount(options, [&](unsigned int threads) {
+				PrintResult("WSAErrorFromName", mix.name, threads,
+					RunPerThreadMix(options, threads, mix.names, [](const std::string& name) { return WSAErrorFromName(name.c_str()); }));
+				PrintResult("baseline unordered_map", mix.name, threads,
+					RunPerThreadMix(options, threads, mix.names, [&](const std::string& name) {
+						auto value = baseline.find(name);
+						return value != baseline.end() ? value->second : 0ul;
+					}));
+			});
+		}
+	}
+}
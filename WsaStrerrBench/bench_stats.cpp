@@ -0,0 +1,166 @@
+﻿// bench_stats.cpp: cost of the sharded error counters, on their own and inside WSAStrError.
+#include "bench_suites.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "wsa_error.h"
+#include "wsa_error_table.h"
+
+namespace bench
+{
+	namespace
+	{
+		unsigned long long TakeTotal()
+		{
+			WSAErrorCount counts[256];
+			size_t n = WSAErrorStatsSnapshot(counts, sizeof(counts) / sizeof(counts[0]), 1);
+			unsigned long long total = 0;
+			for (size_t i = 0; i < n; ++i)
+			{
+				total += counts[i].ullCount;
+			}
+			return total;
+		}
+
+		/* Add a snapshot into per-slot totals, the way the DLL keys its counters */
+		void AddSnapshot(std::vector<unsigned long long>& totals, bool bReset)
+		{
+			WSAErrorCount counts[256];
+			size_t n = WSAErrorStatsSnapshot(counts, sizeof(counts) / sizeof(counts[0]), bReset ? 1 : 0);
+			for (size_t i = 0; i < n; ++i)
+			{
+				std::size_t slot = counts[i].ulErrno != WSA_ERROR_STATS_OTHER ? wsa_strerr::SlotOf(counts[i].ulErrno) : 0;
+				totals[slot] += counts[i].ullCount;
+			}
+		}
+
+		/* Writers record while the main thread keeps snapshotting with reset; every increment must land
+		   in exactly one snapshot, so per code the snapshots plus the final remainder equal what was recorded */
+		void VerifyConcurrentReset(const BenchOptions& options)
+		{
+			TakeTotal();
+			CodeMix mix = MakeUniformMix(10);
+			unsigned int writers = std::max(2u, options.threads);
+			std::uint64_t ops = std::min<std::uint64_t>(options.opsPerThread, 2000000);
+			std::vector<std::vector<unsigned long long>> recorded(writers, std::vector<unsigned long long>(wsa_strerr::slotCount));
+			std::atomic<bool> start{false};
+			std::atomic<unsigned int> running{writers};
+			std::vector<std::thread> pool;
+			for (unsigned int index = 0; index < writers; ++index)
+			{
+				pool.emplace_back([&, index] {
+					while (!start.load(std::memory_order_acquire))
+					{
+						std::this_thread::yield();
+					}
+					std::size_t offset = index * 4099u;
+					for (std::uint64_t i = 0; i < ops; ++i)
+					{
+						unsigned long code = mix[(i + offset) & (mixSize - 1)];
+						WSARecordError(code);
+						++recorded[index][wsa_strerr::SlotOf(code)];
+						if ((i & 4095) == 0)
+						{
+							/* let the snapshots interleave even with fewer cores than threads */
+							std::this_thread::yield();
+						}
+					}
+					running.fetch_sub(1, std::memory_order_release);
+				});
+			}
+			std::vector<unsigned long long> snapshots(wsa_strerr::slotCount);
+			unsigned int snapshotCount = 0;
+			start.store(true, std::memory_order_release);
+			while (running.load(std::memory_order_acquire) != 0)
+			{
+				AddSnapshot(snapshots, true);
+				++snapshotCount;
+			}
+			for (auto& thread : pool)
+			{
+				thread.join();
+			}
+			AddSnapshot(snapshots, false);
+			for (std::size_t slot = 0; slot < wsa_strerr::slotCount; ++slot)
+			{
+				unsigned long long expected = 0;
+				for (const auto& counts : recorded)
+				{
+					expected += counts[slot];
+				}
+				if (snapshots[slot] != expected)
+				{
+					Fail("stats mismatch: slot %zu counted %llu, recorded %llu", slot, snapshots[slot], expected);
+				}
+			}
+			std::printf("concurrent reset: %u writers, %u snapshots, per-code totals match\n", writers, snapshotCount);
+		}
+
+		/* With lookups counted, every translating export records each code it translates once */
+		void VerifyLookupCounting()
+		{
+			TakeTotal();
+			CodeMix mix = MakeUniformMix(11);
+			std::vector<unsigned long long> recorded(wsa_strerr::slotCount);
+			for (unsigned long code : mix)
+			{
+				recorded[wsa_strerr::SlotOf(code)] += 3;
+			}
+			std::vector<const char*> out(mix.size());
+			char buffer[128];
+			WSAErrorStatsCountLookups(1);
+			WSAStrErrorBatch(mix.data(), mix.size(), out.data());
+			for (unsigned long code : mix)
+			{
+				DoNotOptimize(WSAStrError(code));
+				WSAStrError_r(code, buffer, sizeof(buffer), WSA_STRERR_WITH_CODE);
+			}
+			WSAErrorStatsCountLookups(0);
+			std::vector<unsigned long long> counted(wsa_strerr::slotCount);
+			AddSnapshot(counted, true);
+			for (std::size_t slot = 0; slot < wsa_strerr::slotCount; ++slot)
+			{
+				if (counted[slot] != recorded[slot])
+				{
+					Fail("stats mismatch: slot %zu counted %llu lookups, made %llu", slot, counted[slot], recorded[slot]);
+				}
+			}
+		}
+	}
+
+	void RunStatsSuite(const BenchOptions& options)
+	{
+		VerifyConcurrentReset(options);
+		VerifyLookupCounting();
+		PrintHeader("error counters");
+		CodeMix mix = MakeSkewedMix(9);
+		TakeTotal();
+		unsigned long long expected = 0;
+		ForEachThreadCount(options, [&](unsigned int threads) {
+			PrintResult("WSARecordError", "skewed", threads, RunThreads(threads, [&](unsigned int index) {
+				std::size_t offset = index * 4099u;
+				for (std::uint64_t i = 0; i < options.opsPerThread; ++i)
+				{
+					WSARecordError(mix[(i + offset) & (mixSize - 1)]);
+				}
+				return options.opsPerThread;
+			}));
+			expected += options.opsPerThread * threads;
+
+			WSAErrorStatsCountLookups(1);
+			PrintResult("WSAStrError (counting)", "skewed", threads,
+				RunPerThreadMix(options, threads, mix, [](unsigned long code) { return WSAStrError(code); }));
+			WSAErrorStatsCountLookups(0);
+			expected += options.opsPerThread * threads;
+		});
+		unsigned long long total = TakeTotal();
+		if (total != expected)
+		{
+			Fail("stats mismatch: snapshot total %llu, expected %llu", total, expected);
+		}
+		std::printf("snapshot total %llu, expected %llu\n", total, expected);
+	}
+}
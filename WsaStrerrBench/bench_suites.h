@@ -0,0 +1,19 @@
+﻿// bench_suites.h: entry points of the benchmark suites, see bench_main.cpp for the list.
+#pragma once
+
+#include "bench_util.h"
+
+namespace bench
+{
+	void RunLookupSuite(const BenchOptions& options);
+	void RunInitSuite(const BenchOptions& options);
+	void RunFormatSuite(const BenchOptions& options);
+	void RunDetailSuite(const BenchOptions& options);
+	void RunBatchSuite(const BenchOptions& options);
+	void RunStatsSuite(const BenchOptions& options);
+	void RunLogSuite(const BenchOptions& options);
+	void RunNamesSuite(const BenchOptions& options);
+	void RunCategorySuite(const BenchOptions& options);
+	void RunErrnoSuite(const BenchOptions& options);
+	void RunAnnotateSuite(const BenchOptions& options);
+}
@@ -0,0 +1,229 @@
+﻿// bench_util.cpp: timers, thread runner, cache-miss counters and code mixes.
+#include "bench_util.h"
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "wsa_error_table.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace bench
+{
+#if defined(__linux__)
+	CacheMissCounter::CacheMissCounter()
+	{
+		perf_event_attr attr;
+		std::memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = PERF_COUNT_HW_CACHE_MISSES;
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+	}
+
+	CacheMissCounter::~CacheMissCounter()
+	{
+		if (fd >= 0)
+		{
+			close(fd);
+		}
+	}
+
+	void CacheMissCounter::start()
+	{
+		if (fd >= 0)
+		{
+			ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+			ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+
+	std::uint64_t CacheMissCounter::stop()
+	{
+		std::uint64_t count = 0;
+		if (fd >= 0)
+		{
+			ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+			if (read(fd, &count, sizeof(count)) != static_cast<ssize_t>(sizeof(count)))
+			{
+				count = 0;
+			}
+		}
+		return count;
+	}
+#else
+	CacheMissCounter::CacheMissCounter() = default;
+	CacheMissCounter::~CacheMissCounter() = default;
+	void CacheMissCounter::start() {}
+	std::uint64_t CacheMissCounter::stop() { return 0; }
+#endif
+
+	RunResult RunThreads(unsigned int threads, const std::function<std::uint64_t(unsigned int)>& body)
+	{
+		std::atomic<unsigned int> ready{0};
+		std::atomic<bool> go{false};
+		std::vector<std::uint64_t> ops(threads, 0);
+		std::vector<std::uint64_t> elapsed(threads, 0);
+		std::vector<std::uint64_t> misses(threads, 0);
+		std::atomic<bool> countersValid{true};
+
+		std::vector<std::thread> workers;
+		workers.reserve(threads);
+		for (unsigned int i = 0; i < threads; ++i)
+		{
+			workers.emplace_back([&, i]() {
+				CacheMissCounter counter;
+				if (!counter.valid())
+				{
+					countersValid.store(false, std::memory_order_relaxed);
+				}
+				ready.fetch_add(1);
+				while (!go.load(std::memory_order_acquire))
+				{
+					std::this_thread::yield();
+				}
+				counter.start();
+				std::uint64_t begin = NowNs();
+				ops[i] = body(i);
+				elapsed[i] = NowNs() - begin;
+				misses[i] = counter.stop();
+			});
+		}
+		while (ready.load() != threads)
+		{
+			std::this_thread::yield();
+		}
+		std::uint64_t wallBegin = NowNs();
+		go.store(true, std::memory_order_release);
+		for (auto& worker : workers)
+		{
+			worker.join();
+		}
+		std::uint64_t wall = NowNs() - wallBegin;
+
+		RunResult result;
+		std::uint64_t totalOps = 0;
+		std::uint64_t totalMisses = 0;
+		double nsPerOp = 0;
+		for (unsigned int i = 0; i < threads; ++i)
+		{
+			totalOps += ops[i];
+			totalMisses += misses[i];
+			nsPerOp += ops[i] ? static_cast<double>(elapsed[i]) / static_cast<double>(ops[i]) : 0;
+		}
+		result.nsPerOp = nsPerOp / threads;
+		result.mopsPerSec = wall ? static_cast<double>(totalOps) * 1e3 / static_cast<double>(wall) : 0;
+		if (countersValid.load() && totalOps)
+		{
+			result.cacheMissesPerOp = static_cast<double>(totalMisses) / static_cast<double>(totalOps);
+		}
+		return result;
+	}
+
+	void Fail(const char* format, ...)
+	{
+		std::va_list args;
+		va_start(args, format);
+		std::vfprintf(stdout, format, args);
+		va_end(args);
+		std::printf("\n");
+		std::fflush(stdout);
+		std::exit(1);
+	}
+
+	void PrintHeader(const char* title)
+	{
+		std::printf("\n== %s ==\n", title);
+		std::printf("%-28s %-10s %7s %10s %12s %14s\n", "case", "mix", "threads", "ns/op", "Mops/s", "misses/op");
+	}
+
+	void PrintResult(const char* name, const char* mix, unsigned int threads, const RunResult& result)
+	{
+		char misses[32];
+		if (result.cacheMissesPerOp < 0)
+		{
+			std::snprintf(misses, sizeof(misses), "n/a");
+		}
+		else
+		{
+			std::snprintf(misses, sizeof(misses), "%.4f", result.cacheMissesPerOp);
+		}
+		std::printf("%-28s %-10s %7u %10.2f %12.1f %14s\n", name, mix, threads, result.nsPerOp, result.mopsPerSec, misses);
+	}
+
+	CodeMix MakeHitMix(std::uint32_t seed)
+	{
+		std::mt19937 rng(seed);
+		std::uniform_int_distribution<std::size_t> pick(0, wsa_strerr::entryCount - 1);
+		CodeMix mix(mixSize);
+		for (auto& code : mix)
+		{
+			code = wsa_strerr::errorEntries[pick(rng)].code;
+		}
+		return mix;
+	}
+
+	CodeMix MakeMissMix(std::uint32_t seed)
+	{
+		std::mt19937 rng(seed);
+		std::uniform_int_distribution<unsigned long> pick(0, 20000);
+		CodeMix mix(mixSize);
+		for (auto& code : mix)
+		{
+			do
+			{
+				code = pick(rng);
+			} while (wsa_strerr::SlotOf(code) != 0);
+		}
+		return mix;
+	}
+
+	CodeMix MakeSkewedMix(std::uint32_t seed)
+	{
+		/* what a connection-reset storm looks like: mostly WSAEWOULDBLOCK and WSAECONNRESET */
+		std::mt19937 rng(seed);
+		std::uniform_int_distribution<unsigned int> percent(0, 99);
+		std::uniform_int_distribution<std::size_t> pick(0, wsa_strerr::entryCount - 1);
+		CodeMix mix(mixSize);
+		for (auto& code : mix)
+		{
+			unsigned int p = percent(rng);
+			if (p < 60)
+			{
+				code = WSAEWOULDBLOCK;
+			}
+			else if (p < 90)
+			{
+				code = WSAECONNRESET;
+			}
+			else
+			{
+				code = wsa_strerr::errorEntries[pick(rng)].code;
+			}
+		}
+		return mix;
+	}
+
+	CodeMix MakeUniformMix(std::uint32_t seed)
+	{
+		/* uniform over the whole span of known codes, hits and misses alike */
+		std::mt19937 rng(seed);
+		std::uniform_int_distribution<unsigned long> pick(0, WSA_QOS_RESERVED_PETYPE + 1000);
+		CodeMix mix(mixSize);
+		for (auto& code : mix)
+		{
+			code = pick(rng);
+		}
+		return mix;
+	}
+}
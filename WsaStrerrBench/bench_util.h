@@ -0,0 +1,120 @@
+﻿// bench_util.h: small helpers shared by the benchmark suites.
+// Timers, a start barrier for worker threads, hardware cache-miss counters (Linux perf events,
+// reported as n/a elsewhere) and the code mixes the suites feed to the lookups.
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace bench
+{
+	struct BenchOptions
+	{
+		unsigned int threads = 1;
+		std::uint64_t opsPerThread = 20000000;
+	};
+
+	inline std::uint64_t NowNs()
+	{
+		using namespace std::chrono;
+		return static_cast<std::uint64_t>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+	}
+
+	/* Keep the optimizer from dropping a computed value */
+	template <typename T>
+	inline void DoNotOptimize(const T& value)
+	{
+#if defined(__GNUC__)
+		asm volatile("" : : "r,m"(value) : "memory");
+#else
+		static volatile const void* sink;
+		sink = &value;
+#endif
+	}
+
+	/* Hardware cache-miss counter of the calling thread, valid() is false when unsupported */
+	class CacheMissCounter
+	{
+	public:
+		CacheMissCounter();
+		~CacheMissCounter();
+		CacheMissCounter(const CacheMissCounter&) = delete;
+		CacheMissCounter& operator=(const CacheMissCounter&) = delete;
+
+		bool valid() const { return fd >= 0; }
+		void start();
+		std::uint64_t stop();
+
+	private:
+		int fd = -1;
+	};
+
+	struct RunResult
+	{
+		double nsPerOp = 0;              /* average time of one operation as seen by one thread */
+		double mopsPerSec = 0;           /* aggregate throughput over all threads */
+		double cacheMissesPerOp = -1;    /* negative when the counter is unavailable */
+	};
+
+	/* Run body(threadIndex) on `threads` threads released together, body returns the number of
+	   operations it performed */
+	RunResult RunThreads(unsigned int threads, const std::function<std::uint64_t(unsigned int)>& body);
+
+	/* Workload of error codes, size is a power of two so it can be walked with a mask */
+	using CodeMix = std::vector<unsigned long>;
+	inline constexpr std::size_t mixSize = 1u << 16;
+
+	/* Run op on mix elements opsPerThread times per thread, each thread starting at its own offset
+	   into the mix; op returns an integer or a pointer, folded into a sum the optimizer must keep */
+	template <typename Mix, typename Op>
+	RunResult RunPerThreadMix(const BenchOptions& options, unsigned int threads, const Mix& mix, Op op)
+	{
+		return RunThreads(threads, [&](unsigned int index) {
+			std::uintptr_t sum = 0;
+			std::size_t offset = index * 4099u;
+			for (std::uint64_t i = 0; i < options.opsPerThread; ++i)
+			{
+				auto value = op(mix[(i + offset) & (mixSize - 1)]);
+				if constexpr (std::is_pointer_v<decltype(value)>)
+				{
+					sum += reinterpret_cast<std::uintptr_t>(value);
+				}
+				else
+				{
+					sum += static_cast<std::uintptr_t>(value);
+				}
+			}
+			DoNotOptimize(sum);
+			return options.opsPerThread;
+		});
+	}
+
+	/* Call run(threads) on one thread, then on options.threads unless that is one as well */
+	template <typename Run>
+	void ForEachThreadCount(const BenchOptions& options, Run run)
+	{
+		run(1u);
+		if (options.threads != 1)
+		{
+			run(options.threads);
+		}
+	}
+
+	/* Report a failed check (printf format) and end the run with exit status 1 */
+	[[noreturn]] void Fail(const char* format, ...);
+
+	void PrintHeader(const char* title);
+	void PrintResult(const char* name, const char* mix, unsigned int threads, const RunResult& result);
+
+	CodeMix MakeHitMix(std::uint32_t seed);
+	CodeMix MakeMissMix(std::uint32_t seed);
+	CodeMix MakeSkewedMix(std::uint32_t seed);
+	CodeMix MakeUniformMix(std::uint32_t seed);
+}